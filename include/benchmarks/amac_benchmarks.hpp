@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "../containers/amac.hpp"
+#include "../containers/map.hpp"
+#include "../containers/vector.hpp"
+
+namespace benchy {
+    /**
+     * Interleaved (AMAC) lookups against one-at-a-time lookups.
+     * 1. Lower-bound search over a 64 MB sorted shared::vector<uint32_t> (flat_map layout)
+     * 2. Probe chains in a 1M-entry shared::map<int, int>
+     * Interleaved variants sweep the group size G from 1 to 32.
+     */
+
+    static constexpr size_t amac_sorted_size = size_t(1) << 24;
+    static constexpr size_t amac_map_size = size_t(1) << 20;
+    static constexpr size_t amac_lookups = size_t(1) << 16;
+
+    static const shared::vector<uint32_t>& amac_sorted_data() {
+        static const shared::vector<uint32_t> data = [] {
+            shared::vector<uint32_t> v(amac_sorted_size);
+            for (size_t i = 0; i < v.size(); ++i) {
+                v[i] = static_cast<uint32_t>(i * 2);
+            }
+            return v;
+        }();
+        return data;
+    }
+
+    static std::vector<uint32_t> amac_random_keys(uint32_t limit) {
+        std::vector<uint32_t> keys(amac_lookups);
+        std::mt19937 gen(42);
+        for (auto& key : keys) key = gen() % limit;
+        return keys;
+    }
+
+    static void BM_SortedSearchSequential(benchmark::State& state) {
+        const auto& data = amac_sorted_data();
+        auto keys = amac_random_keys(static_cast<uint32_t>(amac_sorted_size * 2));
+        const uint32_t* first = data.data();
+        const uint32_t* last = first + data.size();
+
+        for (auto _ : state) {
+            for (uint32_t key : keys) {
+                benchmark::DoNotOptimize(std::lower_bound(first, last, key));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+    }
+
+    static void BM_SortedSearchInterleaved(benchmark::State& state) {
+        const auto& data = amac_sorted_data();
+        auto keys = amac_random_keys(static_cast<uint32_t>(amac_sorted_size * 2));
+        std::vector<size_t> positions(keys.size());
+
+        for (auto _ : state) {
+            shared::lower_bound_batch(data.data(), data.size(), keys.data(), keys.size(),
+                                      positions.data(), static_cast<size_t>(state.range(0)));
+            benchmark::DoNotOptimize(positions.data());
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+    }
+
+    static const shared::map<int, int>& amac_map() {
+        static const shared::map<int, int> m = [] {
+            shared::map<int, int> built;
+            for (int i = 0; i < static_cast<int>(amac_map_size); ++i) {
+                built[i] = i;
+            }
+            return built;
+        }();
+        return m;
+    }
+
+    static void BM_CustomMapFindSequential(benchmark::State& state) {
+        const auto& m = amac_map();
+        auto raw = amac_random_keys(static_cast<uint32_t>(amac_map_size));
+        std::vector<int> keys(raw.begin(), raw.end());
+
+        for (auto _ : state) {
+            for (int key : keys) {
+                benchmark::DoNotOptimize(m.find(key));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+    }
+
+    static void BM_CustomMapFindInterleaved(benchmark::State& state) {
+        const auto& m = amac_map();
+        auto raw = amac_random_keys(static_cast<uint32_t>(amac_map_size));
+        std::vector<int> keys(raw.begin(), raw.end());
+        std::vector<const int*> results(keys.size());
+
+        for (auto _ : state) {
+            m.find_batch(keys.data(), keys.size(), results.data(), static_cast<size_t>(state.range(0)));
+            benchmark::DoNotOptimize(results.data());
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+    }
+}
+
+// Group sizes G = 1..32
+BENCHMARK(benchy::BM_SortedSearchSequential);
+BENCHMARK(benchy::BM_SortedSearchInterleaved)->RangeMultiplier(2)->Range(1, 32);
+BENCHMARK(benchy::BM_CustomMapFindSequential);
+BENCHMARK(benchy::BM_CustomMapFindInterleaved)->RangeMultiplier(2)->Range(1, 32);
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../containers/async_loader.hpp"
+#include "../containers/vector.hpp"
+#include "../utils/utils.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace benchy {
+    /**
+     * Startup load of many serialized vector images (64 MB in total).
+     * Arg 0 is the file size in KB (4 KB x 16384 files, 64 KB x 1024, 1 MB x 64);
+     * arg 1 = 1 evicts the files from the page cache before each iteration (cold start).
+     * 1. Baseline: load_vector_image per file, one read() after another
+     * 2. load_vector_images on io_uring, queue depth 64
+     * 3. load_vector_images on the thread pool fallback, 8 threads
+     * Files live in the system temp directory (disk or tmpfs, whichever it is).
+     */
+
+    static constexpr size_t image_set_bytes = size_t(64) << 20;
+
+    struct image_set {
+        std::vector<std::unique_ptr<utils::scratch_file>> files;
+        std::vector<std::string> paths;
+    };
+
+    static const std::vector<std::string>& image_paths(size_t kb) {
+        static std::map<size_t, image_set> sets;
+        image_set& set = sets[kb];
+        if (set.paths.empty()) {
+            const size_t count = image_set_bytes / (kb << 10);
+            shared::vector<uint64_t> payload((kb << 10) / sizeof(uint64_t));
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t j = 0; j < payload.size(); ++j) payload[j] = i * payload.size() + j;
+                set.files.push_back(std::make_unique<utils::scratch_file>(
+                    "image_" + std::to_string(kb) + "k_" + std::to_string(i)));
+                set.paths.push_back(set.files.back()->path);
+                shared::save_vector_image(set.paths.back(), payload);
+            }
+            ::sync();
+        }
+        return set.paths;
+    }
+
+    static void evict_images(const std::vector<std::string>& paths) {
+#if defined(POSIX_FADV_DONTNEED)
+        for (const auto& path : paths) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) continue;
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+#else
+        (void)paths;
+#endif
+    }
+
+    template <typename Load>
+    static void run_image_load(benchmark::State& state, Load&& load) {
+        const auto& paths = image_paths(static_cast<size_t>(state.range(0)));
+        const bool cold = state.range(1) != 0;
+
+        for (auto _ : state) {
+            if (cold) {
+                state.PauseTiming();
+                evict_images(paths);
+                state.ResumeTiming();
+            }
+            auto images = load(paths);
+            benchmark::DoNotOptimize(images.data());
+        }
+        state.SetItemsProcessed(state.iterations() * paths.size());
+        state.SetBytesProcessed(state.iterations() * image_set_bytes);
+    }
+
+    static void BM_SyncImageLoad(benchmark::State& state) {
+        run_image_load(state, [](const std::vector<std::string>& paths) {
+            shared::vector<shared::vector<uint64_t>> images(paths.size());
+            for (size_t i = 0; i < paths.size(); ++i) {
+                images[i] = shared::load_vector_image<uint64_t>(paths[i]);
+            }
+            return images;
+        });
+    }
+
+    static void BM_AsyncImageLoad(benchmark::State& state) {
+        shared::async_load_options options;
+        options.use_io_uring = state.range(2) != 0;
+        bool io_uring = false;
+        run_image_load(state, [&](const std::vector<std::string>& paths) {
+            shared::async_load_stats stats;
+            auto images = shared::load_vector_images<uint64_t>(paths, options, &stats);
+            io_uring = stats.io_uring;
+            return images;
+        });
+        state.SetLabel(io_uring ? "io_uring" : "thread_pool");
+    }
+}
+
+// File size in KB x warm/cold page cache (x io_uring/thread pool for the async loader)
+BENCHMARK(benchy::BM_SyncImageLoad)->ArgsProduct({{4, 64, 1024}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_AsyncImageLoad)->ArgsProduct({{4, 64, 1024}, {0, 1}, {1, 0}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+#endif
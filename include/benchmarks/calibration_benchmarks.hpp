@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "../containers/prefetch.hpp"
+#include "../utils/calibration.hpp"
+
+namespace benchy {
+    /**
+     * Hardware calibration suite giving the roofs that container results are compared against.
+     * 1. STREAM copy/scale/add/triad bandwidth from cache-resident to DRAM-resident arrays
+     * 2. Pointer-chase load-to-use latency per cache level (labelled L1/L2/L3/DRAM)
+     * 3. Random 8-byte read throughput, with and without software prefetch
+     *
+     * Working set sizes are per array, from 16 KB to 256 MB.
+     */
+
+    static void BM_StreamCopy(benchmark::State& state) {
+        const size_t n = state.range(0) / sizeof(double);
+        std::vector<double> a(n, 1.0), c(n, 0.0);
+        for (auto _ : state) {
+            utils::stream_copy(c.data(), a.data(), n);
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * 2 * n * sizeof(double));
+        state.SetLabel(utils::cache_level_label(2 * n * sizeof(double)));
+    }
+
+    static void BM_StreamScale(benchmark::State& state) {
+        const size_t n = state.range(0) / sizeof(double);
+        std::vector<double> b(n, 0.0), c(n, 1.0);
+        for (auto _ : state) {
+            utils::stream_scale(b.data(), c.data(), 3.0, n);
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * 2 * n * sizeof(double));
+        state.SetLabel(utils::cache_level_label(2 * n * sizeof(double)));
+    }
+
+    static void BM_StreamAdd(benchmark::State& state) {
+        const size_t n = state.range(0) / sizeof(double);
+        std::vector<double> a(n, 1.0), b(n, 2.0), c(n, 0.0);
+        for (auto _ : state) {
+            utils::stream_add(c.data(), a.data(), b.data(), n);
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * 3 * n * sizeof(double));
+        state.SetLabel(utils::cache_level_label(3 * n * sizeof(double)));
+    }
+
+    static void BM_StreamTriad(benchmark::State& state) {
+        const size_t n = state.range(0) / sizeof(double);
+        std::vector<double> a(n, 0.0), b(n, 2.0), c(n, 1.0);
+        for (auto _ : state) {
+            utils::stream_triad(a.data(), b.data(), c.data(), 3.0, n);
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * 3 * n * sizeof(double));
+        state.SetLabel(utils::cache_level_label(3 * n * sizeof(double)));
+    }
+
+    static void BM_PointerChaseLatency(benchmark::State& state) {
+        const size_t bytes = state.range(0);
+        auto chain = utils::make_pointer_chase(bytes / sizeof(utils::chase_node));
+        const size_t hops = 1 << 16;
+
+        uint64_t p = utils::chase(chain.data(), 0, chain.size());  // warm the working set
+        for (auto _ : state) {
+            p = utils::chase(chain.data(), p, hops);
+            benchmark::DoNotOptimize(p);
+        }
+        state.counters["ns_per_load"] = benchmark::Counter(
+            static_cast<double>(state.iterations() * hops),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+        state.SetLabel(utils::cache_level_label(bytes));
+    }
+
+    template <bool Prefetch>
+    static void BM_RandomAccess(benchmark::State& state) {
+        const size_t n = state.range(0) / sizeof(uint64_t);
+        constexpr size_t distance = 16;
+        std::vector<uint64_t> data(n, 1);
+        std::vector<uint64_t> idx(size_t(1) << 16);
+        std::mt19937_64 gen(42);
+        for (auto& i : idx) i = gen() % n;
+
+        for (auto _ : state) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < idx.size(); ++i) {
+                if constexpr (Prefetch) {
+                    if (i + distance < idx.size()) {
+                        shared::prefetch(&data[idx[i + distance]]);
+                    }
+                }
+                sum += data[idx[i]];
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * idx.size());
+        state.SetLabel(utils::cache_level_label(n * sizeof(uint64_t)));
+    }
+}
+
+// Per-array working sets from 16 KB (L1) to 256 MB (DRAM)
+BENCHMARK(benchy::BM_StreamCopy)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+BENCHMARK(benchy::BM_StreamScale)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+BENCHMARK(benchy::BM_StreamAdd)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+BENCHMARK(benchy::BM_StreamTriad)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+BENCHMARK(benchy::BM_PointerChaseLatency)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+BENCHMARK(benchy::BM_RandomAccess<false>)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
+BENCHMARK(benchy::BM_RandomAccess<true>)->RangeMultiplier(4)->Range(16 << 10, 256 << 20);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "../containers/cow_vector.hpp"
+#include "../containers/vector.hpp"
+
+namespace benchy {
+    /**
+     * shared::cow_vector<uint64_t> against shared::vector<uint64_t>, n elements (arg 0).
+     *
+     * BM_PassByValuePipeline: the vector goes by value through cow_pipeline_depth nested
+     *   stages that each read a few elements, as read-mostly data passed down layers
+     * BM_CopyThenWrite: copy, then write one element (cow_vector's copy happens at the
+     *   write, so both pay one deep copy)
+     * BM_WriteAll: overwrite every element of an unshared vector through the mutation
+     *   API; arg 1 = 0 writes through mutable_at(i) (a reference-count check per write),
+     *   arg 1 = 1 takes mutable_data() once. shared::vector writes through operator[]
+     */
+
+    static constexpr int cow_pipeline_depth = 4;
+
+    inline uint64_t& write_ref(shared::vector<uint64_t>& v, size_t i) { return v[i]; }
+    inline uint64_t& write_ref(shared::cow_vector<uint64_t>& v, size_t i) { return v.mutable_at(i); }
+    inline uint64_t* write_data(shared::vector<uint64_t>& v) { return v.data(); }
+    inline uint64_t* write_data(shared::cow_vector<uint64_t>& v) { return v.mutable_data(); }
+
+    template <typename Vec>
+    static Vec cow_test_vector(size_t n) {
+        shared::vector<uint64_t> v;
+        v.reserve(n);
+        for (uint64_t i = 0; i < n; ++i) v.push_back(i);
+        if constexpr (std::is_same_v<Vec, shared::vector<uint64_t>>) {
+            return v;
+        } else {
+            return Vec(std::move(v));
+        }
+    }
+
+    template <typename Vec>
+    static const char* cow_label() {
+        return std::is_same_v<Vec, shared::vector<uint64_t>> ? "vector" : "cow_vector";
+    }
+
+    template <typename Vec>
+    [[gnu::noinline]] static uint64_t pipeline_stage(Vec v, int depth) {
+        const uint64_t sample = v[0] + v[v.size() / 2] + v[v.size() - 1];
+        return depth == 0 ? sample : sample + pipeline_stage(v, depth - 1);
+    }
+
+    template <typename Vec>
+    static void BM_PassByValuePipeline(benchmark::State& state) {
+        const Vec v = cow_test_vector<Vec>(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(pipeline_stage(v, cow_pipeline_depth - 1));
+        }
+        state.SetItemsProcessed(state.iterations() * cow_pipeline_depth);
+        state.SetLabel(cow_label<Vec>());
+    }
+
+    template <typename Vec>
+    static void BM_CopyThenWrite(benchmark::State& state) {
+        const Vec v = cow_test_vector<Vec>(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            Vec copy = v;
+            write_ref(copy, 0) = 1;
+            benchmark::DoNotOptimize(copy.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * v.size() * sizeof(uint64_t)));
+        state.SetLabel(cow_label<Vec>());
+    }
+
+    template <typename Vec>
+    static void BM_WriteAll(benchmark::State& state) {
+        Vec v = cow_test_vector<Vec>(static_cast<size_t>(state.range(0)));
+        const bool bulk = state.range(1) != 0;
+        uint64_t round = 0;
+        for (auto _ : state) {
+            ++round;
+            if (bulk) {
+                uint64_t* data = write_data(v);
+                for (size_t i = 0; i < v.size(); ++i) data[i] = i ^ round;
+            } else {
+                for (size_t i = 0; i < v.size(); ++i) write_ref(v, i) = i ^ round;
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.size()));
+        state.SetLabel(std::string(cow_label<Vec>()) + (bulk ? ", data pointer" : ", per element"));
+    }
+}
+
+BENCHMARK(benchy::BM_PassByValuePipeline<shared::vector<uint64_t>>)->RangeMultiplier(32)->Range(1 << 5, 1 << 20);
+BENCHMARK(benchy::BM_PassByValuePipeline<shared::cow_vector<uint64_t>>)->RangeMultiplier(32)->Range(1 << 5, 1 << 20);
+BENCHMARK(benchy::BM_CopyThenWrite<shared::vector<uint64_t>>)->RangeMultiplier(32)->Range(1 << 5, 1 << 20);
+BENCHMARK(benchy::BM_CopyThenWrite<shared::cow_vector<uint64_t>>)->RangeMultiplier(32)->Range(1 << 5, 1 << 20);
+BENCHMARK(benchy::BM_WriteAll<shared::vector<uint64_t>>)->ArgsProduct({{1 << 10, 1 << 20}, {0, 1}});
+BENCHMARK(benchy::BM_WriteAll<shared::cow_vector<uint64_t>>)->ArgsProduct({{1 << 10, 1 << 20}, {0, 1}});
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include "../containers/disk_map.hpp"
+#include "../containers/hash.hpp"
+#include "../utils/utils.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace benchy {
+    /**
+     * Random lookups in a shared::disk_map<uint64_t, uint64_t> with a 16 MB page cache.
+     * Arg 0: working set (file size) in tenths of the cache budget, 0.1x to 10x.
+     * Arg 1: 0 = buffered I/O (misses may hit the OS page cache), 1 = O_DIRECT (misses go
+     * to the device; falls back to buffered where unsupported, see label).
+     * Each table is built once per working set in the system temp directory with a large
+     * cache, flushed, and reopened with the budget; the timed loop starts from a warmed cache.
+     * Counters: hit_rate of the page cache and page reads per lookup (at most 1).
+     */
+
+    static constexpr size_t disk_map_cache_bytes = size_t(16) << 20;
+    using disk_test_map = shared::disk_map<uint64_t, uint64_t>;
+
+    static uint64_t disk_map_key(uint64_t i) {
+        return shared::hashes::fmix64(i + 1);
+    }
+
+    /**
+     * Table with keys disk_map_key(0..n) whose page count is about tenths / 10 of the cache
+     */
+    static const std::string& disk_map_table(int64_t tenths, size_t& n) {
+        struct table {
+            utils::scratch_file file;
+            size_t keys;
+            explicit table(const std::string& name) : file(name), keys(0) {}
+        };
+        static std::map<int64_t, std::unique_ptr<table>> tables;
+
+        auto& t = tables[tenths];
+        if (!t) {
+            t = std::make_unique<table>("disk_map_" + std::to_string(tenths));
+            const size_t cache_pages = disk_map_cache_bytes / disk_test_map::page_bytes;
+            const size_t target_pages = std::max<size_t>(cache_pages * static_cast<size_t>(tenths) / 10, 1);
+            shared::disk_map_options build;
+            build.cache_bytes = target_pages * 2 * disk_test_map::page_bytes;
+            disk_test_map m(t->file.path, build);
+            while (m.page_count() < target_pages) {
+                m.insert_or_assign(disk_map_key(t->keys), t->keys);
+                t->keys++;
+            }
+            m.flush();
+        }
+        n = t->keys;
+        return t->file.path;
+    }
+
+    static void BM_DiskMapLookup(benchmark::State& state) {
+        size_t n = 0;
+        const std::string& path = disk_map_table(state.range(0), n);
+        shared::disk_map_options options;
+        options.cache_bytes = disk_map_cache_bytes;
+        options.direct_io = state.range(1) != 0;
+        disk_test_map m(path, options);
+
+        std::mt19937_64 gen(42);
+        for (size_t i = 0; i < 4 * m.cache_pages(); ++i) {
+            benchmark::DoNotOptimize(m.find(disk_map_key(gen() % n)));
+        }
+        m.reset_stats();
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(m.find(disk_map_key(gen() % n)));
+        }
+        const auto& stats = m.stats();
+        const double lookups = static_cast<double>(stats.hits + stats.misses);
+        state.SetItemsProcessed(state.iterations());
+        state.counters["hit_rate"] = lookups ? static_cast<double>(stats.hits) / lookups : 0.0;
+        state.counters["reads_per_lookup"] = lookups ? static_cast<double>(stats.page_reads) / lookups : 0.0;
+        state.counters["file_mb"] = static_cast<double>(m.file_bytes()) / (1 << 20);
+        state.SetLabel(std::string(m.direct_io() ? "O_DIRECT" : "buffered") + " ws=" +
+                       std::to_string(static_cast<double>(state.range(0)) / 10).substr(0, 4) + "x cache");
+    }
+}
+
+BENCHMARK(benchy::BM_DiskMapLookup)->ArgsProduct({{1, 5, 10, 20, 50, 100}, {0, 1}});
+#endif
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include "../containers/file_vector.hpp"
+#include "../containers/vector.hpp"
+#include "../utils/utils.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace benchy {
+    /**
+     * Persistent append-only log: shared::file_vector against shared::vector + fwrite.
+     * 1. Append n 32-byte records and persist them, either page cache only (arg 1 = 0)
+     *    or durably with fdatasync/fsync (arg 1 = 1)
+     * 2. Reopen an existing log of n records: mmap + header read against fread into a vector
+     * Scratch files live in the system temp directory and are removed after each iteration.
+     */
+
+    struct log_record {
+        uint64_t id;
+        uint64_t timestamp;
+        double value;
+        uint32_t kind;
+        uint32_t flags;
+    };
+
+    static log_record make_log_record(uint64_t i) {
+        return log_record{i, i * 1000, static_cast<double>(i) * 0.5, static_cast<uint32_t>(i & 7), 0};
+    }
+
+    static void BM_FileVectorAppend(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const bool durable = state.range(1) != 0;
+        const std::string path = utils::temp_file_path("file_vector_append");
+
+        for (auto _ : state) {
+            {
+                shared::file_vector<log_record> log(path);
+                for (size_t i = 0; i < n; ++i) {
+                    log.push_back(make_log_record(i));
+                }
+                if (durable) log.checkpoint(shared::file_vector<log_record>::sync_mode::full);
+                else log.publish();
+            }
+            state.PauseTiming();
+            std::remove(path.c_str());
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+        state.SetBytesProcessed(state.iterations() * n * sizeof(log_record));
+    }
+
+    static void BM_VectorFwriteAppend(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const bool durable = state.range(1) != 0;
+        const std::string path = utils::temp_file_path("vector_fwrite_append");
+
+        for (auto _ : state) {
+            shared::vector<log_record> log;
+            for (size_t i = 0; i < n; ++i) {
+                log.push_back(make_log_record(i));
+            }
+            FILE* f = std::fopen(path.c_str(), "wb");
+            if (!f) {
+                state.SkipWithError("fopen failed");
+                break;
+            }
+            std::fwrite(log.data(), sizeof(log_record), log.size(), f);
+            std::fflush(f);
+            if (durable) ::fsync(fileno(f));
+            std::fclose(f);
+
+            state.PauseTiming();
+            std::remove(path.c_str());
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+        state.SetBytesProcessed(state.iterations() * n * sizeof(log_record));
+    }
+
+    static void BM_FileVectorReopen(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const std::string path = utils::temp_file_path("file_vector_reopen");
+        {
+            shared::file_vector<log_record> log(path, n);
+            for (size_t i = 0; i < n; ++i) {
+                log.push_back(make_log_record(i));
+            }
+            log.checkpoint(shared::file_vector<log_record>::sync_mode::async);
+        }
+
+        for (auto _ : state) {
+            shared::file_vector<log_record> log(path);
+            benchmark::DoNotOptimize(log.back().id);
+        }
+        std::remove(path.c_str());
+    }
+
+    static void BM_VectorFreadReload(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const std::string path = utils::temp_file_path("vector_fread_reload");
+        {
+            FILE* f = std::fopen(path.c_str(), "wb");
+            for (size_t i = 0; i < n; ++i) {
+                log_record rec = make_log_record(i);
+                std::fwrite(&rec, sizeof(rec), 1, f);
+            }
+            std::fclose(f);
+        }
+
+        for (auto _ : state) {
+            FILE* f = std::fopen(path.c_str(), "rb");
+            shared::vector<log_record> log(n);
+            size_t got = std::fread(log.data(), sizeof(log_record), n, f);
+            std::fclose(f);
+            benchmark::DoNotOptimize(log[got - 1].id);
+        }
+        std::remove(path.c_str());
+    }
+}
+
+// 64K to 4M records (2 MB to 128 MB), page cache only and durable
+BENCHMARK(benchy::BM_FileVectorAppend)->ArgsProduct({{64 << 10, 512 << 10, 4 << 20}, {0, 1}});
+BENCHMARK(benchy::BM_VectorFwriteAppend)->ArgsProduct({{64 << 10, 512 << 10, 4 << 20}, {0, 1}});
+BENCHMARK(benchy::BM_FileVectorReopen)->RangeMultiplier(8)->Range(64 << 10, 4 << 20);
+BENCHMARK(benchy::BM_VectorFreadReload)->RangeMultiplier(8)->Range(64 << 10, 4 << 20);
+#endif
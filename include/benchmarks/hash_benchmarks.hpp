@@ -0,0 +1,289 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../containers/hash.hpp"
+#include "../containers/map.hpp"
+#include "../utils/utils.hpp"
+
+namespace benchy {
+    /**
+     * Hash function suite comparing shared::hash_fn against std::hash and the bundled
+     * fast hashes (FNV-1a, MurmurHash64A, wyhash).
+     * 1. Throughput over 4, 8, 16, 64 and 1024 byte inputs
+     * 2. Avalanche bias: how far each output bit's flip probability is from 0.5
+     *    when a single input bit flips (0 is ideal, 1 means the bit never/always flips)
+     * 3. Bucket chi-squared per degree of freedom under power-of-two masking (~1 is ideal)
+     * 4. Probe lengths the hash produces inside shared::map for each key pattern
+     * 5. Hash flooding: build-and-lookup throughput of a string-keyed map under keys that
+     *    all share one djb2 hash, for the default hasher and seeded_hasher
+     */
+
+    template <size_t N>
+    struct byte_block {
+        unsigned char bytes[N];
+    };
+
+    template <typename T>
+    struct is_byte_block : std::false_type {};
+
+    template <size_t N>
+    struct is_byte_block<byte_block<N>> : std::true_type {};
+
+    // Hash adapters usable both on raw byte blocks and as shared::map's Hash parameter
+    struct hash_fn_adapter {
+        template <typename T>
+        size_t operator()(const T& value) const noexcept { return shared::hash_fn(value); }
+    };
+
+    struct std_hash_adapter {
+        template <typename T>
+        size_t operator()(const T& value) const noexcept {
+            if constexpr (is_byte_block<T>::value) {
+                return std::hash<std::string_view>{}(
+                    std::string_view(reinterpret_cast<const char*>(value.bytes), sizeof(value.bytes)));
+            } else {
+                return std::hash<T>{}(value);
+            }
+        }
+    };
+
+    struct fnv1a_adapter {
+        template <typename T>
+        size_t operator()(const T& value) const noexcept { return shared::fnv1a_hasher<T>{}(value); }
+    };
+
+    struct murmur_adapter {
+        template <typename T>
+        size_t operator()(const T& value) const noexcept { return shared::murmur_hasher<T>{}(value); }
+    };
+
+    struct wy_adapter {
+        template <typename T>
+        size_t operator()(const T& value) const noexcept { return shared::wy_hasher<T>{}(value); }
+    };
+
+    template <typename Hash, size_t N>
+    static void BM_HashThroughput(benchmark::State& state) {
+        std::mt19937_64 gen(42);
+        std::vector<byte_block<N>> blocks(64);
+        for (auto& block : blocks) {
+            for (auto& byte : block.bytes) {
+                byte = static_cast<unsigned char>(gen());
+            }
+        }
+
+        Hash hash;
+        for (auto _ : state) {
+            for (const auto& block : blocks) {
+                benchmark::DoNotOptimize(hash(block));
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * blocks.size() * N);
+        state.SetItemsProcessed(state.iterations() * blocks.size());
+    }
+
+    template <typename Hash>
+    static void BM_HashAvalanche(benchmark::State& state) {
+        constexpr int bits = 64;
+        const size_t trials = static_cast<size_t>(state.range(0));
+        std::mt19937_64 gen(42);
+        Hash hash;
+        double mean_bias = 0, worst_bias = 0;
+
+        for (auto _ : state) {
+            std::vector<uint32_t> flips(bits * bits, 0);
+            for (size_t t = 0; t < trials; ++t) {
+                uint64_t key = gen();
+                uint64_t base = hash(key);
+                for (int in = 0; in < bits; ++in) {
+                    uint64_t diff = base ^ static_cast<uint64_t>(hash(key ^ (uint64_t(1) << in)));
+                    for (int out = 0; out < bits; ++out) {
+                        flips[in * bits + out] += (diff >> out) & 1;
+                    }
+                }
+            }
+
+            mean_bias = worst_bias = 0;
+            for (uint32_t count : flips) {
+                double bias = std::fabs(2.0 * count / trials - 1.0);
+                mean_bias += bias;
+                worst_bias = std::max(worst_bias, bias);
+            }
+            mean_bias /= flips.size();
+        }
+        state.counters["mean_bias"] = mean_bias;
+        state.counters["worst_bias"] = worst_bias;
+    }
+
+    template <typename Hash>
+    static void BM_HashChiSquared(benchmark::State& state) {
+        const auto pattern = static_cast<utils::key_pattern>(state.range(0));
+        const size_t buckets = size_t(1) << state.range(1);
+        auto keys = utils::generate_pattern_keys(buckets * 8, pattern);
+        Hash hash;
+        double chi2_dof = 0;
+
+        for (auto _ : state) {
+            std::vector<uint32_t> counts(buckets, 0);
+            for (uint64_t key : keys) {
+                ++counts[hash(key) & (buckets - 1)];
+            }
+
+            const double expected = static_cast<double>(keys.size()) / buckets;
+            double chi2 = 0;
+            for (uint32_t observed : counts) {
+                chi2 += (observed - expected) * (observed - expected) / expected;
+            }
+            chi2_dof = chi2 / (buckets - 1);
+        }
+        state.counters["chi2_dof"] = chi2_dof;
+        state.SetLabel(utils::key_pattern_name(pattern));
+    }
+
+    template <typename Hash>
+    static void BM_HashMapProbeLength(benchmark::State& state) {
+        const auto pattern = static_cast<utils::key_pattern>(state.range(0));
+        auto keys = utils::generate_pattern_keys(state.range(1), pattern);
+
+        shared::map<uint64_t, uint64_t, 8, Hash> m;
+        for (uint64_t key : keys) {
+            m[key] = key;
+        }
+
+        size_t total_probes = 0, max_probe = 0;
+        for (uint64_t key : keys) {
+            size_t probes = m.probe_length(key);
+            total_probes += probes;
+            max_probe = std::max(max_probe, probes);
+        }
+
+        for (auto _ : state) {
+            for (uint64_t key : keys) {
+                benchmark::DoNotOptimize(m.find(key));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+        state.counters["avg_probe"] = static_cast<double>(total_probes) / keys.size();
+        state.counters["max_probe"] = static_cast<double>(max_probe);
+        state.SetLabel(utils::key_pattern_name(pattern));
+    }
+
+    /**
+     * n (a power of two) distinct strings with identical djb2 hashes: "Ez" and "FY" satisfy
+     * 'E' * 33 + 'z' == 'F' * 33 + 'Y', so every concatenation of log2(n) such blocks collides
+     * in all 64 bits under shared::hash_fn's recurrence (used by hasher<std::string>)
+     */
+    static std::vector<std::string> djb2_flood_keys(size_t n) {
+        size_t blocks = 0;
+        while ((size_t(1) << blocks) < n) ++blocks;
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            std::string key;
+            for (size_t b = 0; b < blocks; ++b) {
+                key += (i >> b) & 1 ? "FY" : "Ez";
+            }
+            keys.push_back(std::move(key));
+        }
+        return keys;
+    }
+
+    static std::vector<std::string> random_keys_like(const std::vector<std::string>& shape) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> letter('A', 'z');
+        std::vector<std::string> keys;
+        keys.reserve(shape.size());
+        for (const auto& s : shape) {
+            std::string key(s.size(), ' ');
+            for (auto& c : key) c = static_cast<char>(letter(gen));
+            keys.push_back(std::move(key));
+        }
+        return keys;
+    }
+
+    /**
+     * Arg 0 keys, arg 1 = 0 random keys, 1 = colliding keys; one iteration inserts then finds all
+     */
+    template <typename Hash>
+    static void BM_MapHashFlood(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const bool attack = state.range(1) != 0;
+        auto keys = djb2_flood_keys(n);
+        if (!attack) keys = random_keys_like(keys);
+
+        for (auto _ : state) {
+            shared::map<std::string, int, 8, Hash> m;
+            for (size_t i = 0; i < n; ++i) {
+                m[keys[i]] = static_cast<int>(i);
+            }
+            for (const auto& key : keys) {
+                benchmark::DoNotOptimize(m.find(key));
+            }
+        }
+
+        shared::map<std::string, int, 8, Hash> m;
+        for (const auto& key : keys) m[key] = 0;
+        size_t max_probe = 0;
+        for (const auto& key : keys) max_probe = std::max(max_probe, m.probe_length(key));
+        state.SetItemsProcessed(state.iterations() * 2 * n);
+        state.counters["max_probe"] = static_cast<double>(max_probe);
+        state.SetLabel(attack ? "colliding keys" : "random keys");
+    }
+}
+
+// Throughput over 4B to 1KB inputs
+BENCHMARK(benchy::BM_HashThroughput<benchy::hash_fn_adapter, 4>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::hash_fn_adapter, 8>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::hash_fn_adapter, 16>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::hash_fn_adapter, 64>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::hash_fn_adapter, 1024>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::std_hash_adapter, 4>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::std_hash_adapter, 8>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::std_hash_adapter, 16>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::std_hash_adapter, 64>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::std_hash_adapter, 1024>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::fnv1a_adapter, 4>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::fnv1a_adapter, 8>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::fnv1a_adapter, 16>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::fnv1a_adapter, 64>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::fnv1a_adapter, 1024>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::murmur_adapter, 4>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::murmur_adapter, 8>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::murmur_adapter, 16>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::murmur_adapter, 64>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::murmur_adapter, 1024>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::wy_adapter, 4>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::wy_adapter, 8>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::wy_adapter, 16>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::wy_adapter, 64>);
+BENCHMARK(benchy::BM_HashThroughput<benchy::wy_adapter, 1024>);
+
+// Avalanche bias over random 64-bit keys
+BENCHMARK(benchy::BM_HashAvalanche<benchy::hash_fn_adapter>)->Arg(1 << 12)->Iterations(1);
+BENCHMARK(benchy::BM_HashAvalanche<benchy::std_hash_adapter>)->Arg(1 << 12)->Iterations(1);
+BENCHMARK(benchy::BM_HashAvalanche<benchy::fnv1a_adapter>)->Arg(1 << 12)->Iterations(1);
+BENCHMARK(benchy::BM_HashAvalanche<benchy::murmur_adapter>)->Arg(1 << 12)->Iterations(1);
+BENCHMARK(benchy::BM_HashAvalanche<benchy::wy_adapter>)->Arg(1 << 12)->Iterations(1);
+
+// Chi-squared per key pattern (sequential, strided, pointer-like) at 2^10 and 2^16 buckets
+BENCHMARK(benchy::BM_HashChiSquared<benchy::hash_fn_adapter>)->ArgsProduct({{0, 1, 2}, {10, 16}})->Iterations(1);
+BENCHMARK(benchy::BM_HashChiSquared<benchy::std_hash_adapter>)->ArgsProduct({{0, 1, 2}, {10, 16}})->Iterations(1);
+BENCHMARK(benchy::BM_HashChiSquared<benchy::fnv1a_adapter>)->ArgsProduct({{0, 1, 2}, {10, 16}})->Iterations(1);
+BENCHMARK(benchy::BM_HashChiSquared<benchy::murmur_adapter>)->ArgsProduct({{0, 1, 2}, {10, 16}})->Iterations(1);
+BENCHMARK(benchy::BM_HashChiSquared<benchy::wy_adapter>)->ArgsProduct({{0, 1, 2}, {10, 16}})->Iterations(1);
+
+// Probe lengths inside shared::map per key pattern (512 to 8K keys)
+BENCHMARK(benchy::BM_HashMapProbeLength<benchy::hash_fn_adapter>)->ArgsProduct({{0, 1, 2}, {512, 8 << 10}});
+BENCHMARK(benchy::BM_HashMapProbeLength<benchy::std_hash_adapter>)->ArgsProduct({{0, 1, 2}, {512, 8 << 10}});
+BENCHMARK(benchy::BM_HashMapProbeLength<benchy::fnv1a_adapter>)->ArgsProduct({{0, 1, 2}, {512, 8 << 10}});
+BENCHMARK(benchy::BM_HashMapProbeLength<benchy::murmur_adapter>)->ArgsProduct({{0, 1, 2}, {512, 8 << 10}});
+BENCHMARK(benchy::BM_HashMapProbeLength<benchy::wy_adapter>)->ArgsProduct({{0, 1, 2}, {512, 8 << 10}});
+
+// Hash flooding: default (unseeded) string hasher against per-instance seeded wyhash
+BENCHMARK(benchy::BM_MapHashFlood<shared::hasher<std::string>>)->ArgsProduct({{1 << 10, 1 << 12, 1 << 14}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_MapHashFlood<shared::seeded_hasher<std::string>>)->ArgsProduct({{1 << 10, 1 << 12, 1 << 14}, {0, 1}})->Unit(benchmark::kMillisecond);
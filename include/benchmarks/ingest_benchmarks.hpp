@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include "../containers/ingest.hpp"
+#include "../containers/thread_pool.hpp"
+#include "../containers/vector.hpp"
+#include "../utils/utils.hpp"
+
+namespace benchy {
+    /**
+     * CSV ingestion of 1M rows (id,user,price,ts; about 34 MB) into shared::vector columns.
+     * 1. shared::csv_reader on 1, 2 and 4 pool threads (arg 0)
+     * 2. Baseline: std::getline per line, fields split with find and parsed with std::stoi/std::stod
+     * The file is written once to the system temp directory; rows/sec is items_per_second.
+     */
+
+    static constexpr size_t csv_rows = size_t(1) << 20;
+
+    static const std::string& csv_input_path() {
+        static const utils::scratch_file input("ingest_input.csv");
+        static const bool written = [] {
+            FILE* f = std::fopen(input.path.c_str(), "wb");
+            std::fputs("id,user,price,ts\n", f);
+            std::mt19937_64 gen(42);
+            for (size_t i = 0; i < csv_rows; ++i) {
+                std::fprintf(f, "%zu,%u,%u.%02u,%u\n", i,
+                    static_cast<unsigned>(gen() % 1000000),
+                    static_cast<unsigned>(gen() % 10000), static_cast<unsigned>(gen() % 100),
+                    1700000000u + static_cast<unsigned>(i));
+            }
+            std::fclose(f);
+            return true;
+        }();
+        (void)written;
+        return input.path;
+    }
+
+    static void BM_CsvIngest(benchmark::State& state) {
+        const std::string& path = csv_input_path();
+        shared::thread_pool pool(static_cast<size_t>(state.range(0)));
+        shared::csv_options options;
+        options.header = true;
+
+        size_t rows = 0;
+        for (auto _ : state) {
+            shared::csv_reader reader({shared::column_type::int64, shared::column_type::int64,
+                                       shared::column_type::float64, shared::column_type::int64},
+                                      options, &pool);
+            rows = reader.ingest_file(path);
+            benchmark::DoNotOptimize(reader.column(2).floats.data());
+        }
+        state.SetItemsProcessed(state.iterations() * rows);
+    }
+
+    static void BM_CsvGetlineStoi(benchmark::State& state) {
+        const std::string& path = csv_input_path();
+
+        size_t rows = 0;
+        for (auto _ : state) {
+            shared::vector<int64_t> id, user, ts;
+            shared::vector<double> price;
+            std::ifstream in(path);
+            std::string line;
+            std::getline(in, line);
+            while (std::getline(in, line)) {
+                size_t a = line.find(',');
+                size_t b = line.find(',', a + 1);
+                size_t c = line.find(',', b + 1);
+                id.push_back(static_cast<int64_t>(std::stoi(line.substr(0, a))));
+                user.push_back(static_cast<int64_t>(std::stoi(line.substr(a + 1, b - a - 1))));
+                price.push_back(std::stod(line.substr(b + 1, c - b - 1)));
+                ts.push_back(static_cast<int64_t>(std::stoi(line.substr(c + 1))));
+            }
+            rows = id.size();
+            benchmark::DoNotOptimize(price.data());
+        }
+        state.SetItemsProcessed(state.iterations() * rows);
+    }
+}
+
+BENCHMARK(benchy::BM_CsvIngest)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_CsvGetlineStoi)->Unit(benchmark::kMillisecond)->UseRealTime();
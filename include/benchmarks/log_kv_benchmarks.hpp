@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include "../containers/log_kv.hpp"
+#include "../utils/utils.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace benchy {
+    /**
+     * shared::log_kv in a directory under the system temp path, 100-byte values.
+     *
+     * BM_LogKvDurablePut: every put waits for durability (fdatasync); with more writer
+     *   threads one group commit covers several puts (puts_per_commit)
+     * BM_LogKvBufferedPut: puts return once buffered; commits every 1 MB or 2 ms.
+     *   Arg: key space; a small one overwrites keys constantly, so background compaction
+     *   keeps disk_mb bounded (compactions, reclaimed_mb)
+     * BM_LogKvGet: random gets over 1M keys (index probe + one pread, served by the OS
+     *   page cache once warm)
+     * BM_LogKvRecovery: time to open a 1M-key store and rebuild its index from hint files
+     *   (arg 1) or, with the hints deleted, by scanning the logs (arg 0). Recovery rewrites
+     *   the hint of every scanned sealed segment, so arg 0 also times those hint writes,
+     *   their fsyncs and a directory sync: the cost of the first open after losing hints
+     */
+
+    static constexpr size_t log_kv_value_bytes = 100;
+    static constexpr size_t log_kv_store_keys = size_t(1) << 20;
+
+    static std::string log_kv_key(uint64_t i) {
+        char key[24];
+        std::snprintf(key, sizeof(key), "key%012llu", static_cast<unsigned long long>(i));
+        return key;
+    }
+
+    static std::string log_kv_value(uint64_t i) {
+        std::string value(log_kv_value_bytes, 'v');
+        const std::string id = std::to_string(i);
+        value.replace(0, id.size(), id);
+        return value;
+    }
+
+    /**
+     * Directory holding a store with log_kv_store_keys keys, built once per name
+     */
+    static const std::string& log_kv_store(const std::string& name) {
+        static std::map<std::string, std::unique_ptr<utils::scratch_dir>> stores;
+        auto& dir = stores[name];
+        if (!dir) {
+            dir = std::make_unique<utils::scratch_dir>(name);
+            shared::log_kv_options options;
+            options.sync = false;
+            shared::log_kv kv(dir->path, options);
+            for (uint64_t i = 0; i < log_kv_store_keys; ++i) {
+                kv.put(log_kv_key(i), log_kv_value(i));
+            }
+            kv.sync();
+        }
+        return dir->path;
+    }
+
+    static void BM_LogKvDurablePut(benchmark::State& state) {
+        static std::unique_ptr<utils::scratch_dir> dir;
+        static std::unique_ptr<shared::log_kv> kv;
+        static std::atomic<uint64_t> next_key{0};
+        if (state.thread_index() == 0) {
+            dir = std::make_unique<utils::scratch_dir>("log_kv_durable");
+            kv = std::make_unique<shared::log_kv>(dir->path);
+            next_key = 0;
+        }
+
+        const std::string value = log_kv_value(0);
+        for (auto _ : state) {
+            const uint64_t i = next_key.fetch_add(1, std::memory_order_relaxed);
+            kv->wait_durable(kv->put(log_kv_key(i), value));
+        }
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index() == 0) {
+            // Runs after every thread has left the loop
+            const auto stats = kv->stats();
+            state.counters["puts_per_commit"] = stats.commits ? static_cast<double>(stats.puts) / stats.commits : 0.0;
+            kv.reset();
+            dir.reset();
+        }
+    }
+
+    static void BM_LogKvBufferedPut(benchmark::State& state) {
+        const uint64_t key_space = static_cast<uint64_t>(state.range(0));
+        utils::scratch_dir dir("log_kv_buffered");
+        shared::log_kv_options options;
+        options.segment_bytes = size_t(16) << 20;
+        shared::log_kv kv(dir.path, options);
+
+        std::mt19937_64 gen(42);
+        const std::string value = log_kv_value(0);
+        for (auto _ : state) {
+            kv.put(log_kv_key(gen() % key_space), value);
+        }
+        kv.sync();
+        const auto stats = kv.stats();
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(static_cast<int64_t>(stats.bytes_appended));
+        state.counters["commits"] = static_cast<double>(stats.commits);
+        state.counters["compactions"] = static_cast<double>(stats.compactions);
+        state.counters["reclaimed_mb"] = static_cast<double>(stats.bytes_reclaimed) / (1 << 20);
+        state.counters["disk_mb"] = static_cast<double>(kv.disk_bytes()) / (1 << 20);
+        state.counters["live_keys"] = static_cast<double>(kv.size());
+    }
+
+    static void BM_LogKvGet(benchmark::State& state) {
+        shared::log_kv_options options;
+        options.background_compaction = false;
+        shared::log_kv kv(log_kv_store("log_kv_get"), options);
+
+        std::mt19937_64 gen(42);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(kv.get(log_kv_key(gen() % log_kv_store_keys)));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    static void BM_LogKvRecovery(benchmark::State& state) {
+        const bool hints = state.range(0) != 0;
+        const std::string& path = log_kv_store("log_kv_recovery");
+        shared::log_kv_options options;
+        options.background_compaction = false;
+
+        for (auto _ : state) {
+            if (!hints) {
+                for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                    if (entry.path().extension() == ".hint") std::filesystem::remove(entry.path());
+                }
+            }
+            const auto start = std::chrono::steady_clock::now();
+            auto kv = std::make_unique<shared::log_kv>(path, options);
+            state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            if (kv->size() != log_kv_store_keys) state.SkipWithError("log_kv: recovered key count mismatch");
+            kv.reset();
+        }
+        state.SetItemsProcessed(state.iterations() * log_kv_store_keys);
+        state.SetLabel(hints ? "hint files" : "log scan + hint rewrite");
+    }
+}
+
+BENCHMARK(benchy::BM_LogKvDurablePut)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+BENCHMARK(benchy::BM_LogKvBufferedPut)->Arg(1 << 16)->Arg(1 << 24);
+BENCHMARK(benchy::BM_LogKvGet);
+BENCHMARK(benchy::BM_LogKvRecovery)->Arg(1)->Arg(0)->UseManualTime()->Unit(benchmark::kMillisecond);
+#endif
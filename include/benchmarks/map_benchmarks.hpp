@@ -1,6 +1,16 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../containers/fixed_key.hpp"
+#include "../containers/hash.hpp"
 #include "../containers/map.hpp"
+#include "../utils/calibration.hpp"
 #include "../utils/utils.hpp"
 
 namespace benchy {
@@ -54,6 +64,34 @@ namespace benchy {
         }
     }
 
+    /**
+     * Lookups in random key order, reported as a percentage of the calibrated
+     * random DRAM read roof (pct_of_random_roof); values above 100 mean the
+     * table is cache resident
+     */
+    static void BM_CustomMapRandomLookup(benchmark::State& state) {
+        const int n = static_cast<int>(state.range(0));
+        shared::map<int, int> m;
+        for (int i = 0; i < n; ++i) {
+            m[i] = i;
+        }
+
+        std::vector<int> order(n);
+        std::mt19937 gen(42);
+        for (auto& key : order) key = static_cast<int>(gen() % n);
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto _ : state) {
+            for (int key : order) {
+                benchmark::DoNotOptimize(m.find(key));
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double lookups = static_cast<double>(state.iterations()) * n;
+        state.SetItemsProcessed(static_cast<int64_t>(lookups));
+        state.counters["pct_of_random_roof"] = utils::percent_of_roof(lookups, seconds, utils::calibrated_roofs().random_reads_per_sec);
+    }
+
     static void BM_CustomMapStringInsertion(benchmark::State& state) {
         auto keys = benchy::utils::generate_random_data<std::string>(state.range(0));
         for (auto _ : state) {
@@ -73,6 +111,417 @@ namespace benchy {
             }
         }
     }
+
+    /**
+     * String insertion and lookup suite by key representation, on the same 5-15 byte keys:
+     * std::string with the default hasher, std::string with wy_hasher (isolates the hash),
+     * and short_string_key stored inline with a SIMD compare. Keys are converted before timing
+     */
+    template <typename Key>
+    static std::vector<Key> string_suite_keys(size_t n) {
+        auto strings = benchy::utils::generate_random_data<std::string>(n);
+        return std::vector<Key>(strings.begin(), strings.end());
+    }
+
+    template <typename Map, typename Key>
+    static void BM_StringKeyMapInsertion(benchmark::State& state) {
+        auto keys = string_suite_keys<Key>(state.range(0));
+        for (auto _ : state) {
+            Map m;
+            for (int i = 0; i < state.range(0); ++i) {
+                m[keys[i]] = i;
+            }
+            benchmark::DoNotOptimize(m.size());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Map, typename Key>
+    static void BM_StringKeyMapLookup(benchmark::State& state) {
+        auto keys = string_suite_keys<Key>(state.range(0));
+        Map m;
+        for (int i = 0; i < state.range(0); ++i) {
+            m[keys[i]] = i;
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+        for (auto _ : state) {
+            for (const auto& key : keys) {
+                benchmark::DoNotOptimize(m.find(key));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    /**
+     * Counter increments (word-count style): exactly 8 increments per distinct key in random order,
+     * starting from an empty map. Arg 1 = 0 uses ++m[key], arg 1 = 1 uses upsert().
+     * operator[] checks the load factor before probing, so hits can trigger growth;
+     * bucket_count shows the resulting table size (6 and 3 << 14 keys sit exactly at 0.75)
+     */
+    static void BM_CustomMapCounterIncrement(benchmark::State& state) {
+        const int distinct = static_cast<int>(state.range(0));
+        const bool use_upsert = state.range(1) != 0;
+        std::vector<int> keys(static_cast<size_t>(distinct) * 8);
+        for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int>(i % distinct);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+        size_t buckets = 0;
+        for (auto _ : state) {
+            shared::map<int, int> m;
+            if (use_upsert) {
+                for (int key : keys) {
+                    m.upsert(key, 1, [](int& count) { ++count; });
+                }
+            } else {
+                for (int key : keys) {
+                    ++m[key];
+                }
+            }
+            buckets = m.bucket_count();
+            benchmark::DoNotOptimize(m.find(keys[0]));
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+        state.counters["bucket_count"] = static_cast<double>(buckets);
+        state.SetLabel(use_upsert ? "upsert" : "operator[]");
+    }
+
+    /**
+     * Load factor against throughput and memory, on random 64-bit keys with wy_hasher.
+     * Sweep: the growth threshold is fixed at arg 0 percent and the table is filled to it
+     * (2^20 buckets), then looked up with 50% hits / 50% misses in random order.
+     * Adaptive: 600K inserts in batches of 4096, each followed by 4 lookups per insert
+     * with arg 1 percent misses; arg 0 selects fixed 0.75, fixed 0.95 or adaptive [0.5, 0.95]
+     */
+    using load_test_map = shared::map<uint64_t, uint64_t, 8, shared::wy_hasher<uint64_t>>;
+
+    static void set_memory_counters(benchmark::State& state, const load_test_map& m) {
+        state.counters["load"] = m.load_factor();
+        state.counters["bytes_per_key"] = static_cast<double>(m.memory_bytes()) / m.size();
+    }
+
+    static void BM_CustomMapLoadFactorSweep(benchmark::State& state) {
+        const float lf = static_cast<float>(state.range(0)) / 100.0f;
+        const size_t buckets = size_t(1) << 20;
+        size_t n = static_cast<size_t>(lf * buckets);
+        while (static_cast<float>(n) / buckets > lf) --n;
+
+        load_test_map m;
+        m.max_load_factor(lf);
+        m.reserve(n);
+        std::mt19937_64 gen(42);
+        std::vector<uint64_t> lookups;
+        lookups.reserve(2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t key = gen();
+            m[key] = i;
+            lookups.push_back(key);
+            lookups.push_back(gen());
+        }
+        std::shuffle(lookups.begin(), lookups.end(), gen);
+
+        for (auto _ : state) {
+            for (uint64_t key : lookups) {
+                benchmark::DoNotOptimize(m.find(key));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * lookups.size());
+        set_memory_counters(state, m);
+    }
+
+    static void BM_CustomMapAdaptiveLoad(benchmark::State& state) {
+        static const char* names[] = {"fixed 0.75", "fixed 0.95", "adaptive 0.5-0.95"};
+        const int mode = static_cast<int>(state.range(0));
+        const uint64_t miss_pct = static_cast<uint64_t>(state.range(1));
+        const size_t n = 600000, batch = 4096;
+        shared::load_policy policy;
+        policy.min_load = mode == 2 ? 0.5f : (mode == 0 ? 0.75f : 0.95f);
+        policy.max_load = mode == 0 ? 0.75f : 0.95f;
+
+        std::mt19937_64 gen(42);
+        std::vector<uint64_t> keys(n);
+        for (auto& key : keys) key = gen();
+        std::vector<uint64_t> lookups(4 * n);
+        for (size_t i = 0; i < lookups.size(); ++i) {
+            // Lookups only name keys from batches already inserted
+            const size_t inserted = (i / (4 * batch) + 1) * batch;
+            lookups[i] = gen() % 100 < miss_pct ? gen() : keys[gen() % std::min(inserted, n)];
+        }
+
+        float final_limit = 0.0f;
+        for (auto _ : state) {
+            load_test_map m(policy);
+            for (size_t begin = 0; begin < n; begin += batch) {
+                const size_t end = std::min(begin + batch, n);
+                for (size_t i = begin; i < end; ++i) {
+                    m[keys[i]] = i;
+                }
+                for (size_t i = 4 * begin; i < 4 * end; ++i) {
+                    benchmark::DoNotOptimize(m.find(lookups[i]));
+                }
+            }
+            final_limit = m.max_load_factor();
+            state.PauseTiming();
+            set_memory_counters(state, m);
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * 5 * n);
+        state.counters["final_limit"] = final_limit;
+        state.SetLabel(names[mode]);
+    }
+
+    /**
+     * String-key lookup pipeline over 16 shards: shard selector (top hash bits), per-shard
+     * bloom filter (two middle-bit probes), then the shard's table probe. Half the lookups
+     * are absent keys, most of which the filter rejects. Shards hash with wy_hasher: the
+     * default djb2 hasher leaves the high bits of short-string hashes skewed (65% of
+     * random keys landed in shard 0), which would leave one loaded shard and filter.
+     * Arg 1 = 0 rehashes the key at every stage and probes with find();
+     * arg 1 = 1 computes hash_of(key) once and reuses it, probing with find_hashed()
+     */
+    class sharded_string_store {
+    public:
+        static constexpr size_t shard_count = 16;
+        static constexpr size_t filter_bits = 1 << 16;
+
+        void insert(const std::string& key, int value) {
+            const size_t hash = shards[0].hash_of(key);
+            auto& shard = shards[shard_of(hash)];
+            set_filter(shard_of(hash), hash);
+            shard.try_emplace_hashed(key, hash, value);
+        }
+
+        const int* find(const std::string& key) const {
+            const size_t s = shard_of(shards[0].hash_of(key));
+            if (!filter_has(s, shards[0].hash_of(key))) return nullptr;
+            return shards[s].find(key);
+        }
+
+        const int* find_prehashed(const std::string& key) const {
+            const size_t hash = shards[0].hash_of(key);
+            const size_t s = shard_of(hash);
+            if (!filter_has(s, hash)) return nullptr;
+            return shards[s].find_hashed(key, hash);
+        }
+
+    private:
+        shared::map<std::string, int, 8, shared::wy_hasher<std::string>> shards[shard_count];
+        std::vector<uint64_t> filters = std::vector<uint64_t>(shard_count * filter_bits / 64);
+
+        static size_t shard_of(size_t hash) { return (hash >> 60) & (shard_count - 1); }
+        static size_t bit_a(size_t hash) { return (hash >> 24) & (filter_bits - 1); }
+        static size_t bit_b(size_t hash) { return (hash >> 40) & (filter_bits - 1); }
+
+        void set_filter(size_t s, size_t hash) {
+            uint64_t* f = filters.data() + s * (filter_bits / 64);
+            f[bit_a(hash) / 64] |= uint64_t(1) << (bit_a(hash) % 64);
+            f[bit_b(hash) / 64] |= uint64_t(1) << (bit_b(hash) % 64);
+        }
+
+        bool filter_has(size_t s, size_t hash) const {
+            const uint64_t* f = filters.data() + s * (filter_bits / 64);
+            return (f[bit_a(hash) / 64] >> (bit_a(hash) % 64) & 1) &&
+                   (f[bit_b(hash) / 64] >> (bit_b(hash) % 64) & 1);
+        }
+    };
+
+    static void BM_CustomMapStringLookupPipeline(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const bool prehashed = state.range(1) != 0;
+        auto keys = benchy::utils::generate_random_data<std::string>(2 * n);
+        sharded_string_store store;
+        for (size_t i = 0; i < n; ++i) {
+            store.insert(keys[i], static_cast<int>(i));
+        }
+
+        // Fresh string objects, so lookups cannot rely on matching object bytes
+        std::vector<std::string> probes(keys.begin(), keys.end());
+        std::shuffle(probes.begin(), probes.end(), std::mt19937(42));
+
+        size_t hits = 0;
+        for (auto _ : state) {
+            for (const auto& key : probes) {
+                const int* found = prehashed ? store.find_prehashed(key) : store.find(key);
+                hits += found != nullptr;
+                benchmark::DoNotOptimize(found);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * probes.size());
+        state.counters["hit_rate"] = static_cast<double>(hits) / (static_cast<double>(state.iterations()) * probes.size());
+        state.SetLabel(prehashed ? "hash once" : "rehash per stage");
+    }
+
+    /**
+     * Slot relocation on a u64 -> u64 map (wy_hasher) with n random keys, arg 0.
+     * Grow: inserting n keys from empty (every doubling rehashes); Clone: clone() of the
+     * filled map; Iterate: summing values over begin()/end().
+     * The value is uint64_t (trivially copyable slots: memcpy rehash and clone) or
+     * boxed_u64, the same 8 bytes with a user-provided copy constructor, which reproduces
+     * the earlier move-only pair (slot-by-slot construction and copies)
+     */
+    struct boxed_u64 {
+        uint64_t value;
+
+        boxed_u64() noexcept : value(0) {}
+        boxed_u64(uint64_t v) noexcept : value(v) {}
+        boxed_u64(const boxed_u64& other) noexcept : value(other.value) {}
+        boxed_u64& operator=(const boxed_u64& other) noexcept {
+            value = other.value;
+            return *this;
+        }
+
+        operator uint64_t() const noexcept { return value; }
+    };
+
+    template <typename V>
+    using pod_test_map = shared::map<uint64_t, V, 8, shared::wy_hasher<uint64_t>>;
+
+    template <typename V>
+    static const char* slot_label() {
+        return std::is_trivially_copyable_v<V> ? "trivially copyable slots" : "non-trivial slots";
+    }
+
+    static std::vector<uint64_t> pod_test_keys(size_t n) {
+        std::vector<uint64_t> keys(n);
+        for (size_t i = 0; i < n; ++i) keys[i] = shared::hashes::fmix64(i + 1);
+        return keys;
+    }
+
+    template <typename V>
+    static pod_test_map<V> filled_pod_map(const std::vector<uint64_t>& keys) {
+        pod_test_map<V> m;
+        for (size_t i = 0; i < keys.size(); ++i) m.try_emplace(keys[i], keys[i]);
+        return m;
+    }
+
+    template <typename V>
+    static void BM_PodMapGrow(benchmark::State& state) {
+        const auto keys = pod_test_keys(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            auto m = filled_pod_map<V>(keys);
+            benchmark::DoNotOptimize(m.find(keys[0]));
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+        state.SetLabel(slot_label<V>());
+    }
+
+    template <typename V>
+    static void BM_PodMapClone(benchmark::State& state) {
+        const auto keys = pod_test_keys(static_cast<size_t>(state.range(0)));
+        const auto m = filled_pod_map<V>(keys);
+        for (auto _ : state) {
+            auto copy = m.clone();
+            benchmark::DoNotOptimize(copy.find(keys[0]));
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * m.memory_bytes()));
+        state.SetLabel(slot_label<V>());
+    }
+
+    template <typename V>
+    static void BM_PodMapIterate(benchmark::State& state) {
+        const auto keys = pod_test_keys(static_cast<size_t>(state.range(0)));
+        auto m = filled_pod_map<V>(keys);
+        for (auto _ : state) {
+            uint64_t sum = 0;
+            for (auto& [key, value] : m) sum += key ^ static_cast<uint64_t>(value);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+        state.SetLabel(slot_label<V>());
+    }
+
+    /**
+     * Set algebra on two u64 -> u64 maps of n random keys each (arg 0) that share half
+     * their keys. Arg 1 = 0 is the element-wise loop over begin()/end() (try_emplace into
+     * the target for merge; building a new map of the survivors with find() for the
+     * others, as the map has no erase); arg 1 = 1 is the bulk member (merge, intersect,
+     * subtract, retain_if keeping odd values). Both inputs are cloned outside the timing.
+     */
+    struct set_op_inputs {
+        pod_test_map<uint64_t> a;
+        pod_test_map<uint64_t> b;
+    };
+
+    static const set_op_inputs& set_op_maps(size_t n) {
+        static std::map<size_t, std::unique_ptr<set_op_inputs>> inputs;
+        auto& in = inputs[n];
+        if (!in) {
+            in = std::make_unique<set_op_inputs>();
+            for (size_t i = 0; i < n; ++i) {
+                in->a.try_emplace(shared::hashes::fmix64(i + 1), i);
+                in->b.try_emplace(shared::hashes::fmix64(n / 2 + i + 1), i);
+            }
+        }
+        return *in;
+    }
+
+    template <typename Bulk, typename Loop>
+    static void run_set_op(benchmark::State& state, Bulk bulk, Loop loop) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const bool use_bulk = state.range(1) != 0;
+        const set_op_inputs& in = set_op_maps(n);
+        size_t result_size = 0;
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto a = in.a.clone();
+            auto b = in.b.clone();
+            state.ResumeTiming();
+            if (use_bulk) {
+                bulk(a, b);
+            } else {
+                loop(a, b);
+            }
+            result_size = a.size();
+            state.PauseTiming();
+            { auto drop_a = std::move(a); auto drop_b = std::move(b); }
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+        state.counters["result_size"] = static_cast<double>(result_size);
+        state.SetLabel(use_bulk ? "bulk" : "element-wise");
+    }
+
+    template <typename Keep>
+    static void rebuild_where(pod_test_map<uint64_t>& a, Keep keep) {
+        pod_test_map<uint64_t> out;
+        for (auto& [key, value] : a) {
+            if (keep(key, value)) out.try_emplace(key, value);
+        }
+        a = std::move(out);
+    }
+
+    static void BM_MapMerge(benchmark::State& state) {
+        run_set_op(state,
+            [](auto& a, auto& b) { a.merge(std::move(b)); },
+            [](auto& a, auto& b) {
+                for (auto& [key, value] : b) a.try_emplace(key, value);
+            });
+    }
+
+    static void BM_MapIntersect(benchmark::State& state) {
+        run_set_op(state,
+            [](auto& a, auto& b) { a.intersect(b); },
+            [](auto& a, auto& b) {
+                rebuild_where(a, [&b](uint64_t key, uint64_t) { return b.find(key) != nullptr; });
+            });
+    }
+
+    static void BM_MapSubtract(benchmark::State& state) {
+        run_set_op(state,
+            [](auto& a, auto& b) { a.subtract(b); },
+            [](auto& a, auto& b) {
+                rebuild_where(a, [&b](uint64_t key, uint64_t) { return b.find(key) == nullptr; });
+            });
+    }
+
+    static void BM_MapRetainIf(benchmark::State& state) {
+        run_set_op(state,
+            [](auto& a, auto&) { a.retain_if([](uint64_t, uint64_t value) { return (value & 1) != 0; }); },
+            [](auto& a, auto&) {
+                rebuild_where(a, [](uint64_t, uint64_t value) { return (value & 1) != 0; });
+            });
+    }
 }
 
 // Register benchmarks with increasing sizes (8 to 8K elements)
@@ -80,5 +529,26 @@ BENCHMARK(benchy::BM_CustomMapInsertion)->Range(8, 8 << 10);
 BENCHMARK(benchy::BM_StdMapInsertion)->Range(8, 8 << 10);
 BENCHMARK(benchy::BM_CustomMapLookup)->Range(8, 8 << 10);
 BENCHMARK(benchy::BM_StdMapLookup)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_CustomMapRandomLookup)->RangeMultiplier(16)->Range(8 << 10, 1 << 20);
 BENCHMARK(benchy::BM_CustomMapStringInsertion)->Range(8, 8 << 10);
-BENCHMARK(benchy::BM_StdMapStringInsertion)->Range(8, 8 << 10); 
\ No newline at end of file
+BENCHMARK(benchy::BM_StdMapStringInsertion)->Range(8, 8 << 10); 
+BENCHMARK(benchy::BM_CustomMapStringLookupPipeline)->ArgsProduct({{1 << 10, 1 << 16}, {0, 1}});
+BENCHMARK(benchy::BM_CustomMapCounterIncrement)->ArgsProduct({{6, 1 << 10, 3 << 14}, {0, 1}});
+BENCHMARK(benchy::BM_StringKeyMapInsertion<shared::map<std::string, int>, std::string>)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_StringKeyMapInsertion<shared::map<std::string, int, 8, shared::wy_hasher<std::string>>, std::string>)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_StringKeyMapInsertion<shared::short_string_map<int>, shared::short_string_key>)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_StringKeyMapLookup<shared::map<std::string, int>, std::string>)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_StringKeyMapLookup<shared::map<std::string, int, 8, shared::wy_hasher<std::string>>, std::string>)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_StringKeyMapLookup<shared::short_string_map<int>, shared::short_string_key>)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_CustomMapLoadFactorSweep)->DenseRange(50, 95, 5);
+BENCHMARK(benchy::BM_CustomMapAdaptiveLoad)->ArgsProduct({{0, 1, 2}, {0, 50, 90}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_PodMapGrow<uint64_t>)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchy::BM_PodMapGrow<benchy::boxed_u64>)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchy::BM_PodMapClone<uint64_t>)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchy::BM_PodMapClone<benchy::boxed_u64>)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchy::BM_PodMapIterate<uint64_t>)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchy::BM_PodMapIterate<benchy::boxed_u64>)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchy::BM_MapMerge)->ArgsProduct({{1 << 20, 10000000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_MapIntersect)->ArgsProduct({{1 << 20, 10000000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_MapSubtract)->ArgsProduct({{1 << 20, 10000000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_MapRetainIf)->ArgsProduct({{1 << 20, 10000000}, {0, 1}})->Unit(benchmark::kMillisecond);
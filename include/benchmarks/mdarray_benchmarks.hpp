@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "../containers/mdarray.hpp"
+
+namespace benchy {
+    /**
+     * n x n float grids (arg 0) under each shared::mdarray layout (template argument).
+     *
+     * BM_GridTraversal: sum every element; arg 1 = 0 row by row, 1 column by column
+     *   (both through operator()), 2 in storage order (for_each)
+     * BM_GridTranspose: transpose into a second grid of the same layout; arg 1 = 0 is
+     *   the textbook double loop, 1 the cache-oblivious shared::transpose
+     */
+
+    template <typename Layout>
+    static shared::mdarray<float, Layout> grid_test_array(size_t n) {
+        shared::mdarray<float, Layout> a(n, n);
+        a.view().for_each_indexed([](size_t r, size_t c, float& v) { v = static_cast<float>((r + c) & 0xff); });
+        return a;
+    }
+
+    template <typename Layout>
+    static void BM_GridTraversal(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const auto a = grid_test_array<Layout>(n);
+        const int64_t order = state.range(1);
+        for (auto _ : state) {
+            float sum = 0;
+            if (order == 0) {
+                for (size_t r = 0; r < n; r++) {
+                    for (size_t c = 0; c < n; c++) sum += a(r, c);
+                }
+            } else if (order == 1) {
+                for (size_t c = 0; c < n; c++) {
+                    for (size_t r = 0; r < n; r++) sum += a(r, c);
+                }
+            } else {
+                a.for_each([&](float v) { sum += v; });
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        static const char* labels[] = {"row order", "column order", "storage order"};
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n * n * sizeof(float)));
+        state.SetLabel(labels[order]);
+    }
+
+    template <typename Layout>
+    static void BM_GridTranspose(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const auto a = grid_test_array<Layout>(n);
+        shared::mdarray<float, Layout> b(n, n);
+        for (auto _ : state) {
+            if (state.range(1) == 0) {
+                for (size_t r = 0; r < n; r++) {
+                    for (size_t c = 0; c < n; c++) b(c, r) = a(r, c);
+                }
+            } else {
+                shared::transpose(a, b);
+            }
+            benchmark::DoNotOptimize(b.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+        state.SetLabel(state.range(1) == 0 ? "double loop" : "cache-oblivious");
+    }
+}
+
+BENCHMARK(benchy::BM_GridTraversal<shared::layout_right>)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_GridTraversal<shared::layout_left>)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_GridTraversal<shared::layout_tiled<>>)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_GridTranspose<shared::layout_right>)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_GridTranspose<shared::layout_left>)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_GridTranspose<shared::layout_tiled<>>)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1}})->Unit(benchmark::kMillisecond);
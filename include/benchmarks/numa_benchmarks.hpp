@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "../containers/numa.hpp"
+#include "../containers/thread_pool.hpp"
+#include "../containers/vector.hpp"
+#include "../utils/calibration.hpp"
+
+namespace benchy {
+    /**
+     * Page placement of a 256 MB shared::vector<double> and the parallel scan that follows.
+     * Arg 0 selects the placement: 0 = serial, 1 = first_touch, 2 = interleave.
+     * The pool has one worker per hardware thread, pinned round-robin across NUMA nodes;
+     * scans give worker w the same numa::page_chunk it constructed.
+     * On a single node all placements behave alike (use numa=fake=N to emulate nodes).
+     */
+
+    static constexpr size_t placement_elements = size_t(32) << 20;
+
+    static shared::thread_pool& placement_pool() {
+        static shared::thread_pool pool(std::thread::hardware_concurrency(), shared::numa::spread_workers());
+        return pool;
+    }
+
+    static void set_placement_label(benchmark::State& state, shared::numa_placement placement) {
+        static const char* names[] = {"serial", "first_touch", "interleave"};
+        state.SetLabel(std::string(names[static_cast<int>(placement)]) + " nodes=" +
+                       std::to_string(shared::numa::node_count()));
+    }
+
+    static void BM_VectorPlacementConstruct(benchmark::State& state) {
+        const auto placement = static_cast<shared::numa_placement>(state.range(0));
+        auto& pool = placement_pool();
+        for (auto _ : state) {
+            shared::vector<double> v(placement_elements, 1.0, pool, placement);
+            benchmark::DoNotOptimize(v.data());
+        }
+        state.SetBytesProcessed(state.iterations() * placement_elements * sizeof(double));
+        set_placement_label(state, placement);
+    }
+
+    static void BM_VectorPlacementScan(benchmark::State& state) {
+        const auto placement = static_cast<shared::numa_placement>(state.range(0));
+        auto& pool = placement_pool();
+        const size_t workers = pool.size();
+        shared::vector<double> v(placement_elements, 1.0, pool, placement);
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto _ : state) {
+            pool.for_each_worker([&](size_t worker) {
+                auto chunk = shared::numa::page_chunk(v.data(), v.size(), sizeof(double), worker, workers);
+                benchmark::DoNotOptimize(utils::stream_sum(v.data() + chunk.first, chunk.second - chunk.first));
+            });
+        }
+        const double bytes = static_cast<double>(state.iterations()) * v.size() * sizeof(double);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.counters["pct_of_read_roof"] = utils::percent_of_roof(bytes, seconds, utils::calibrated_roofs().read_bytes_per_sec);
+        set_placement_label(state, placement);
+    }
+}
+
+BENCHMARK(benchy::BM_VectorPlacementConstruct)->DenseRange(0, 2)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_VectorPlacementScan)->DenseRange(0, 2)->Unit(benchmark::kMillisecond)->UseRealTime();
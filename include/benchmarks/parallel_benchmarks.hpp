@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../containers/hash.hpp"
+#include "../containers/map.hpp"
+#include "../containers/parallel.hpp"
+#include "../containers/thread_pool.hpp"
+#include "../containers/vector.hpp"
+#include "../utils/calibration.hpp"
+
+namespace benchy {
+    /**
+     * Parallel sum of values over a 25M-entry u64 -> u64 map (~800 MB of slots) and a
+     * 100M-element u64 vector (800 MB). Arg: worker threads; 0 is the sequential
+     * begin()/end() loop. Otherwise ranges(4 * threads) are summed as pool tasks with a
+     * local accumulator per range (the prefetching range for_each) and the partials
+     * combined. Reported against the calibrated sequential read roof.
+     * The map size is bounded by memory: 100M entries would need a 6.4 GB slot array.
+     */
+
+    static constexpr size_t parallel_map_entries = 25000000;  // Just under 0.75 of 2^25 slots
+    static constexpr size_t parallel_vector_elements = 100000000;
+
+    using parallel_test_map = shared::map<uint64_t, uint64_t, 8, shared::wy_hasher<uint64_t>>;
+
+    static parallel_test_map& parallel_sum_map() {
+        static std::unique_ptr<parallel_test_map> m;
+        if (!m) {
+            m = std::make_unique<parallel_test_map>();
+            m->reserve(parallel_map_entries);
+            for (uint64_t i = 0; i < parallel_map_entries; ++i) {
+                m->try_emplace(shared::hashes::fmix64(i + 1), i);
+            }
+        }
+        return *m;
+    }
+
+    static shared::vector<uint64_t>& parallel_sum_vector() {
+        static std::unique_ptr<shared::vector<uint64_t>> v;
+        if (!v) {
+            v = std::make_unique<shared::vector<uint64_t>>();
+            v->reserve(parallel_vector_elements);
+            for (uint64_t i = 0; i < parallel_vector_elements; ++i) v->push_back(i);
+        }
+        return *v;
+    }
+
+    /**
+     * Sums value(e) over c, one local accumulator per range
+     */
+    template <typename Container, typename Value>
+    static uint64_t parallel_sum(Container& c, shared::thread_pool& pool, Value value) {
+        auto parts = c.ranges(pool.size() * 4);
+        std::vector<uint64_t> partials(parts.size());
+        pool.parallel_for(parts.size(), [&](size_t i) {
+            uint64_t sum = 0;
+            parts[i].for_each([&](auto& e) { sum += value(e); });
+            partials[i] = sum;
+        });
+        uint64_t total = 0;
+        for (uint64_t s : partials) total += s;
+        return total;
+    }
+
+    template <typename Container, typename Value>
+    static void run_parallel_sum(benchmark::State& state, Container& c, double bytes_per_pass, Value value) {
+        const size_t threads = static_cast<size_t>(state.range(0));
+        std::unique_ptr<shared::thread_pool> pool;
+        if (threads) pool = std::make_unique<shared::thread_pool>(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto _ : state) {
+            uint64_t sum = 0;
+            if (pool) {
+                sum = parallel_sum(c, *pool, value);
+            } else {
+                for (auto& e : c) sum += value(e);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        const double bytes = static_cast<double>(state.iterations()) * bytes_per_pass;
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * c.size()));
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.counters["pct_of_read_roof"] = utils::percent_of_roof(bytes, seconds, utils::calibrated_roofs().read_bytes_per_sec);
+        state.SetLabel(threads ? std::to_string(threads) + " threads, ranges" : "sequential iterator");
+    }
+
+    static void BM_MapParallelSum(benchmark::State& state) {
+        auto& m = parallel_sum_map();
+        run_parallel_sum(state, m, static_cast<double>(m.memory_bytes()),
+                         [](const shared::pair<uint64_t, uint64_t>& e) { return e.second; });
+    }
+
+    static void BM_VectorParallelSum(benchmark::State& state) {
+        auto& v = parallel_sum_vector();
+        run_parallel_sum(state, v, static_cast<double>(v.size() * sizeof(uint64_t)),
+                         [](uint64_t e) { return e; });
+    }
+}
+
+BENCHMARK(benchy::BM_MapParallelSum)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_VectorParallelSum)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
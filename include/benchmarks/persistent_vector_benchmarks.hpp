@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "../containers/persistent_vector.hpp"
+#include "../containers/vector.hpp"
+
+namespace benchy {
+    /**
+     * shared::persistent_vector<uint64_t> against keeping versions of a shared::vector
+     * by copying it. n elements (arg 0); arg 1 = 0 is the vector, 1 the persistent vector.
+     *
+     * BM_VersionPushBack / BM_VersionUpdate: new version with one element appended /
+     *   replaced at a random index; the old version stays valid (vector: copy, then edit)
+     * BM_VersionIndex: random reads; arg 1 = 2 reads a persistent vector built by
+     *   concatenating odd-sized pieces (relaxed nodes, size-table search)
+     * BM_VersionConcat: new version joining two n/2-element versions
+     * BM_PersistentBuild: n appends into one sequence; arg 1: 0 vector push_back,
+     *   1 v = v.push_back(x) (const& push_back: v is shared during the call, so every
+     *   push copies the tail, and a full tail the path; the old version dies at the
+     *   assignment, none are kept),
+     *   2 rvalue push_back (edits in place), 3 transient
+     */
+
+    using persistent_u64 = shared::persistent_vector<uint64_t>;
+
+    static shared::vector<uint64_t> version_test_vector(size_t n) {
+        shared::vector<uint64_t> v;
+        v.reserve(n);
+        for (uint64_t i = 0; i < n; ++i) v.push_back(i);
+        return v;
+    }
+
+    static persistent_u64 version_test_persistent(size_t n) {
+        auto t = persistent_u64().transient();
+        for (uint64_t i = 0; i < n; ++i) t.push_back(i);
+        return t.persistent();
+    }
+
+    static persistent_u64 version_test_concatenated(size_t n) {
+        persistent_u64 out;
+        std::mt19937_64 gen(42);
+        uint64_t next = 0;
+        while (next < n) {
+            const uint64_t piece = std::min<uint64_t>(1 + gen() % 100, n - next);
+            auto t = persistent_u64().transient();
+            for (uint64_t i = 0; i < piece; ++i) t.push_back(next++);
+            out = out.concat(t.persistent());
+        }
+        return out;
+    }
+
+    static const char* version_label(int64_t impl) {
+        switch (impl) {
+            case 0: return "vector copy";
+            case 1: return "persistent";
+            default: return "persistent, concat-built";
+        }
+    }
+
+    static void BM_VersionPushBack(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        if (state.range(1) == 0) {
+            const auto v = version_test_vector(n);
+            for (auto _ : state) {
+                shared::vector<uint64_t> next = v;
+                next.push_back(n);
+                benchmark::DoNotOptimize(next.data());
+            }
+        } else {
+            const auto v = version_test_persistent(n);
+            for (auto _ : state) {
+                auto next = v.push_back(n);
+                benchmark::DoNotOptimize(next.size());
+            }
+        }
+        state.SetLabel(version_label(state.range(1)));
+    }
+
+    static void BM_VersionUpdate(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        std::mt19937_64 gen(42);
+        if (state.range(1) == 0) {
+            const auto v = version_test_vector(n);
+            for (auto _ : state) {
+                shared::vector<uint64_t> next = v;
+                next[gen() % n] = 0;
+                benchmark::DoNotOptimize(next.data());
+            }
+        } else {
+            const auto v = version_test_persistent(n);
+            for (auto _ : state) {
+                auto next = v.set(gen() % n, 0);
+                benchmark::DoNotOptimize(next.size());
+            }
+        }
+        state.SetLabel(version_label(state.range(1)));
+    }
+
+    static void BM_VersionIndex(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        std::mt19937_64 gen(42);
+        uint64_t sum = 0;
+        if (state.range(1) == 0) {
+            const auto v = version_test_vector(n);
+            for (auto _ : state) sum += v[gen() % n];
+        } else {
+            const auto v = state.range(1) == 1 ? version_test_persistent(n) : version_test_concatenated(n);
+            state.counters["depth"] = v.depth();
+            for (auto _ : state) sum += v[gen() % n];
+        }
+        benchmark::DoNotOptimize(sum);
+        state.SetItemsProcessed(state.iterations());
+        state.SetLabel(version_label(state.range(1)));
+    }
+
+    static void BM_VersionConcat(benchmark::State& state) {
+        const size_t half = static_cast<size_t>(state.range(0)) / 2;
+        if (state.range(1) == 0) {
+            const auto a = version_test_vector(half);
+            const auto b = version_test_vector(half);
+            for (auto _ : state) {
+                shared::vector<uint64_t> next;
+                next.reserve(2 * half);
+                next.assign(a.data(), half);
+                for (size_t i = 0; i < half; ++i) next.push_back(b[i]);
+                benchmark::DoNotOptimize(next.data());
+            }
+        } else {
+            const auto a = version_test_persistent(half);
+            const auto b = version_test_persistent(half);
+            for (auto _ : state) {
+                auto next = a.concat(b);
+                benchmark::DoNotOptimize(next.size());
+            }
+        }
+        state.SetLabel(version_label(state.range(1)));
+    }
+
+    static void BM_PersistentBuild(benchmark::State& state) {
+        const size_t n = static_cast<size_t>(state.range(0));
+        const int64_t mode = state.range(1);
+        for (auto _ : state) {
+            if (mode == 0) {
+                shared::vector<uint64_t> v;
+                for (uint64_t i = 0; i < n; ++i) v.push_back(i);
+                benchmark::DoNotOptimize(v.data());
+            } else if (mode == 1) {
+                persistent_u64 v;
+                for (uint64_t i = 0; i < n; ++i) v = v.push_back(i);
+                benchmark::DoNotOptimize(v.size());
+            } else if (mode == 2) {
+                persistent_u64 v;
+                for (uint64_t i = 0; i < n; ++i) v = std::move(v).push_back(i);
+                benchmark::DoNotOptimize(v.size());
+            } else {
+                auto t = persistent_u64().transient();
+                for (uint64_t i = 0; i < n; ++i) t.push_back(i);
+                benchmark::DoNotOptimize(t.persistent().size());
+            }
+        }
+        static const char* labels[] = {"vector push_back", "const& push_back", "rvalue push_back", "transient"};
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+        state.SetLabel(labels[mode]);
+    }
+}
+
+BENCHMARK(benchy::BM_VersionPushBack)->ArgsProduct({{1 << 10, 1 << 15, 1 << 20}, {0, 1}});
+BENCHMARK(benchy::BM_VersionUpdate)->ArgsProduct({{1 << 10, 1 << 15, 1 << 20}, {0, 1}});
+BENCHMARK(benchy::BM_VersionIndex)->ArgsProduct({{1 << 10, 1 << 20}, {0, 1, 2}});
+BENCHMARK(benchy::BM_VersionConcat)->ArgsProduct({{1 << 10, 1 << 15, 1 << 20}, {0, 1}});
+BENCHMARK(benchy::BM_PersistentBuild)->ArgsProduct({{1 << 20}, {0, 1, 2, 3}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "../containers/hash.hpp"
+#include "../containers/map.hpp"
+#include "../containers/segmented_map.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace benchy {
+    /**
+     * Growth cost of shared::map (whole-table doubling) against shared::segmented_map
+     * (per-segment splits) while inserting distinct random 64-bit keys.
+     * Entries: 100M, capped so shared::map's growth peak (old + new table) stays within
+     * half of physical memory; the count used is in the label.
+     * Counters: per-insert latency percentiles and max (ns, timed individually, so they
+     * include ~20-40 ns of clock overhead), peak_rss_mb above the pre-run RSS (VmHWM,
+     * reset through /proc/self/clear_refs on Linux) and final_rss_mb.
+     */
+
+    static constexpr size_t growth_target_entries = 100000000;
+
+    /**
+     * Log-linear latency histogram: 8 sub-buckets per power of two (~12% resolution)
+     */
+    class latency_histogram {
+        uint64_t counts[64 * 8] = {};
+        uint64_t total = 0;
+        uint64_t max_ns = 0;
+
+        static int log2_floor(uint64_t ns) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - __builtin_clzll(ns);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanReverse64(&index, ns);
+            return static_cast<int>(index);
+#else
+            int log = 0;
+            while (ns >>= 1) ++log;
+            return log;
+#endif
+        }
+
+        static size_t bucket(uint64_t ns) noexcept {
+            if (ns < 8) return static_cast<size_t>(ns);
+            const int log = log2_floor(ns);
+            return static_cast<size_t>(log) * 8 + ((ns >> (log - 3)) & 7);
+        }
+
+        static uint64_t lower_bound(size_t b) noexcept {
+            if (b < 8) return b;
+            const size_t log = b / 8;
+            return (uint64_t(8) | (b & 7)) << (log - 3);
+        }
+
+    public:
+        void add(uint64_t ns) noexcept {
+            counts[bucket(ns)]++;
+            total++;
+            max_ns = std::max(max_ns, ns);
+        }
+
+        double percentile(double p) const noexcept {
+            const uint64_t rank = static_cast<uint64_t>(p / 100.0 * total);
+            uint64_t seen = 0;
+            for (size_t b = 0; b < 64 * 8; b++) {
+                seen += counts[b];
+                if (seen > rank) return static_cast<double>(lower_bound(b));
+            }
+            return static_cast<double>(max_ns);
+        }
+
+        double max() const noexcept { return static_cast<double>(max_ns); }
+    };
+
+    static double proc_status_mb(const std::string& field) {
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        double kb = 0;
+        while (status >> key) {
+            if (key == field) {
+                status >> kb;
+                break;
+            }
+        }
+        return kb / 1024.0;
+    }
+
+    static void reset_peak_rss() {
+        std::ofstream("/proc/self/clear_refs") << "5";
+    }
+
+    static size_t growth_entries() {
+        size_t ram = size_t(8) << 30;
+#if defined(_SC_PHYS_PAGES)
+        const long pages = ::sysconf(_SC_PHYS_PAGES);
+        if (pages > 0) ram = static_cast<size_t>(pages) * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+        shared::map<uint64_t, uint64_t> probe;
+        const size_t slot_bytes = probe.memory_bytes() / probe.bucket_count();
+        // Filled to 0.75, the last doubling holds the old and new tables: 1.5x the final one
+        size_t buckets = 8;
+        while (buckets / 4 * 3 < growth_target_entries && 2 * buckets * slot_bytes * 3 / 2 <= ram / 2) {
+            buckets *= 2;
+        }
+        return std::min(growth_target_entries, buckets / 4 * 3);
+    }
+
+    template <typename Map>
+    static void BM_GrowthTailLatency(benchmark::State& state) {
+        const size_t n = growth_entries();
+        for (auto _ : state) {
+            latency_histogram histogram;
+            const double base_rss = proc_status_mb("VmRSS:");
+            reset_peak_rss();
+            auto start = std::chrono::steady_clock::now();
+            {
+                Map m;
+                for (size_t i = 0; i < n; ++i) {
+                    const uint64_t key = shared::hashes::fmix64(i + 1);
+                    const auto before = std::chrono::steady_clock::now();
+                    m[key] = i;
+                    const auto after = std::chrono::steady_clock::now();
+                    histogram.add(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+                }
+                state.counters["final_rss_mb"] = proc_status_mb("VmRSS:") - base_rss;
+                benchmark::DoNotOptimize(m.find(1));
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            state.SetIterationTime(seconds);
+            state.counters["peak_rss_mb"] = proc_status_mb("VmHWM:") - base_rss;
+            state.counters["p50_ns"] = histogram.percentile(50);
+            state.counters["p99_ns"] = histogram.percentile(99);
+            state.counters["p99.9_ns"] = histogram.percentile(99.9);
+            state.counters["p99.99_ns"] = histogram.percentile(99.99);
+            state.counters["max_ns"] = histogram.max();
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+        state.SetLabel(std::to_string(n) + " entries");
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+BENCHMARK(benchy::BM_GrowthTailLatency<shared::map<uint64_t, uint64_t, 8, shared::wy_hasher<uint64_t>>>)
+    ->Iterations(1)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_GrowthTailLatency<shared::segmented_map<uint64_t, uint64_t, shared::wy_hasher<uint64_t>>>)
+    ->Iterations(1)->UseManualTime()->Unit(benchmark::kMillisecond);
+#endif
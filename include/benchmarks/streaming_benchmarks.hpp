@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+#include "../containers/streaming_store.hpp"
+#include "../containers/vector.hpp"
+#include "../utils/calibration.hpp"
+
+namespace benchy {
+    /**
+     * Bulk copy and fill of a DRAM-sized shared::vector<double> with regular stores
+     * (arg 0 = 0) or non-temporal streaming stores (arg 0 = 1).
+     * 1. Copy construction (fresh pages), assign(first, n) into existing capacity and
+     *    assign(n, val) throughput
+     * 2. The same copy while a co-runner thread chases pointers through a cache-resident
+     *    working set; corunner_slowdown is its idle hop rate over its rate during the copies.
+     *    On a single core the co-runner also loses CPU time to the copier, so compare the
+     *    two store modes with each other rather than against 1.0
+     */
+
+    class streaming_mode_scope {
+        size_t _saved;
+    public:
+        explicit streaming_mode_scope(bool streaming) : _saved(shared::streaming::threshold()) {
+            shared::streaming::threshold() = streaming ? _saved : std::numeric_limits<size_t>::max();
+        }
+        ~streaming_mode_scope() { shared::streaming::threshold() = _saved; }
+    };
+
+    static void set_streaming_label(benchmark::State& state, bool streaming) {
+        state.SetLabel(streaming ? std::string("movnt ") + shared::streaming::isa_name(shared::streaming::active_isa())
+                                 : std::string("regular"));
+    }
+
+    static void BM_VectorBulkCopy(benchmark::State& state) {
+        const bool streaming = state.range(0) != 0;
+        streaming_mode_scope mode(streaming);
+        const size_t n = utils::dram_working_set_bytes() / sizeof(double);
+        shared::vector<double> src;
+        src.assign(n, 1.5);
+
+        for (auto _ : state) {
+            shared::vector<double> copy(src);
+            benchmark::DoNotOptimize(copy.data());
+        }
+        state.SetBytesProcessed(state.iterations() * n * sizeof(double));
+        set_streaming_label(state, streaming);
+    }
+
+    static void BM_VectorBulkAssign(benchmark::State& state) {
+        const bool streaming = state.range(0) != 0;
+        streaming_mode_scope mode(streaming);
+        const size_t n = utils::dram_working_set_bytes() / sizeof(double);
+        shared::vector<double> src;
+        src.assign(n, 1.5);
+        shared::vector<double> dst(n);
+
+        for (auto _ : state) {
+            dst.assign(src.data(), n);
+            benchmark::DoNotOptimize(dst.data());
+        }
+        state.SetBytesProcessed(state.iterations() * n * sizeof(double));
+        set_streaming_label(state, streaming);
+    }
+
+    static void BM_VectorBulkFill(benchmark::State& state) {
+        const bool streaming = state.range(0) != 0;
+        streaming_mode_scope mode(streaming);
+        const size_t n = utils::dram_working_set_bytes() / sizeof(double);
+        shared::vector<double> v(n);
+
+        double value = 0.0;
+        for (auto _ : state) {
+            v.assign(n, value += 1.0);
+            benchmark::DoNotOptimize(v.data());
+        }
+        state.SetBytesProcessed(state.iterations() * n * sizeof(double));
+        set_streaming_label(state, streaming);
+    }
+
+    /**
+     * Pointer chase over a cache-resident chain on its own thread, counting hops
+     */
+    class chase_co_runner {
+        std::vector<utils::chase_node> _chain;
+        std::atomic<bool> _stop{false};
+        std::atomic<uint64_t> _hops{0};
+        std::thread _thread;
+
+    public:
+        explicit chase_co_runner(size_t bytes) : _chain(utils::make_pointer_chase(bytes / sizeof(utils::chase_node))) {
+            _thread = std::thread([this] {
+                uint64_t p = 0;
+                while (!_stop.load(std::memory_order_relaxed)) {
+                    p = utils::chase(_chain.data(), p, 4096);
+                    _hops.fetch_add(4096, std::memory_order_relaxed);
+                }
+                benchmark::DoNotOptimize(p);
+            });
+        }
+
+        ~chase_co_runner() {
+            _stop = true;
+            _thread.join();
+        }
+
+        uint64_t hops() const { return _hops.load(std::memory_order_relaxed); }
+    };
+
+    static void BM_VectorBulkCopyCoRunner(benchmark::State& state) {
+        const bool streaming = state.range(0) != 0;
+        streaming_mode_scope mode(streaming);
+        const size_t n = utils::dram_working_set_bytes() / sizeof(double);
+        const size_t hot_bytes = std::clamp(utils::last_level_cache_bytes() / 4, size_t(1) << 20, size_t(16) << 20);
+        shared::vector<double> src;
+        src.assign(n, 1.5);
+        chase_co_runner co_runner(hot_bytes);
+
+        auto rate_over = [&co_runner](auto&& during) {
+            const uint64_t hops_before = co_runner.hops();
+            auto start = std::chrono::steady_clock::now();
+            during();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return static_cast<double>(co_runner.hops() - hops_before) / seconds;
+        };
+        const double idle_rate = rate_over([] { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+
+        const double busy_rate = rate_over([&] {
+            for (auto _ : state) {
+                shared::vector<double> copy(src);
+                benchmark::DoNotOptimize(copy.data());
+            }
+        });
+        state.SetBytesProcessed(state.iterations() * n * sizeof(double));
+        state.counters["corunner_slowdown"] = busy_rate > 0 ? idle_rate / busy_rate : 0.0;
+        set_streaming_label(state, streaming);
+    }
+}
+
+BENCHMARK(benchy::BM_VectorBulkCopy)->DenseRange(0, 1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_VectorBulkAssign)->DenseRange(0, 1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_VectorBulkFill)->DenseRange(0, 1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(benchy::BM_VectorBulkCopyCoRunner)->DenseRange(0, 1)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -1,6 +1,12 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
 #include <vector>
 #include "../containers/vector.hpp"
+#include "../utils/calibration.hpp"
 #include "../utils/utils.hpp"
 
 namespace benchy {
@@ -58,10 +64,106 @@ namespace benchy {
             }
         }
     }
+
+    /**
+     * Random-index reads into a 4 GB shared::vector<uint64_t> (capped at half of physical
+     * memory) for each allocation option (arg 0):
+     * 0 = operator new, 1 = huge pages, 2 = populate, 3 = huge pages + populate, 4 = willneed
+     * setup_ms times allocation + fill, where first-touch page faults land without prefault;
+     * anon_huge_mb is the process's THP-backed anonymous memory after setup (Linux).
+     */
+    static size_t random_access_bytes() {
+        size_t bytes = size_t(4) << 30;
+#if defined(_SC_PHYS_PAGES)
+        const long pages = ::sysconf(_SC_PHYS_PAGES);
+        if (pages > 0) bytes = std::min(bytes, static_cast<size_t>(pages) * shared::pages::page_bytes() / 2);
+#endif
+        return bytes;
+    }
+
+    static double anon_huge_mb() {
+        std::ifstream rollup("/proc/self/smaps_rollup");
+        std::string key;
+        double kb = 0;
+        while (rollup >> key) {
+            if (key == "AnonHugePages:") {
+                rollup >> kb;
+                break;
+            }
+        }
+        return kb / 1024.0;
+    }
+
+    static shared::alloc_options access_alloc_options(int64_t option) {
+        shared::alloc_options options;
+        options.huge_pages = option == 1 || option == 3;
+        if (option == 2 || option == 3) options.prefault = shared::prefault_mode::populate;
+        if (option == 4) options.prefault = shared::prefault_mode::willneed;
+        return options;
+    }
+
+    static void BM_CustomVectorAccessRandom(benchmark::State& state) {
+        static const char* labels[] = {"operator_new", "huge_pages", "populate", "huge_pages+populate", "willneed"};
+        const size_t n = random_access_bytes() / sizeof(uint64_t);
+        constexpr size_t reads = size_t(1) << 20;
+
+        auto setup_start = std::chrono::steady_clock::now();
+        shared::vector<uint64_t> v(access_alloc_options(state.range(0)));
+        v.resize(n, 1);
+        const double setup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setup_start).count();
+
+        uint64_t x = 0x9e3779b97f4a7c15ull;
+        for (auto _ : state) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < reads; ++i) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                // Multiply-shift maps 32 random bits onto [0, n) without a division
+                sum += v[static_cast<size_t>(((x & 0xffffffffu) * n) >> 32)];
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * reads);
+        state.counters["setup_ms"] = setup_ms;
+        state.counters["anon_huge_mb"] = anon_huge_mb();
+        state.SetLabel(std::string(labels[state.range(0)]) + " " + std::to_string(n * sizeof(uint64_t) >> 20) + "MB");
+    }
+
+    /**
+     * Streaming read of the whole vector, reported as a percentage of the
+     * calibrated sequential read roof (pct_of_read_roof)
+     */
+    static void BM_CustomVectorScan(benchmark::State& state) {
+        shared::vector<double> v(static_cast<size_t>(state.range(0)));
+        auto start = std::chrono::steady_clock::now();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(utils::stream_sum(v.data(), v.size()));
+        }
+        const double bytes = static_cast<double>(state.iterations()) * v.size() * sizeof(double);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.counters["pct_of_read_roof"] = utils::percent_of_roof(bytes, seconds, utils::calibrated_roofs().read_bytes_per_sec);
+    }
+
+    static void BM_StdVectorScan(benchmark::State& state) {
+        std::vector<double> v(static_cast<size_t>(state.range(0)));
+        auto start = std::chrono::steady_clock::now();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(utils::stream_sum(v.data(), v.size()));
+        }
+        const double bytes = static_cast<double>(state.iterations()) * v.size() * sizeof(double);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.counters["pct_of_read_roof"] = utils::percent_of_roof(bytes, seconds, utils::calibrated_roofs().read_bytes_per_sec);
+    }
 }
 
 // Register benchmarks with exponentially increasing sizes
 BENCHMARK(benchy::BM_CustomVectorPushBack)->Range(8, 8 << 10);
 BENCHMARK(benchy::BM_StdVectorPushBack)->Range(8, 8 << 10);
 BENCHMARK(benchy::BM_CustomVectorAccess)->Range(8, 8 << 10);
-BENCHMARK(benchy::BM_StdVectorAccess)->Range(8, 8 << 10); 
\ No newline at end of file
+BENCHMARK(benchy::BM_StdVectorAccess)->Range(8, 8 << 10);
+BENCHMARK(benchy::BM_CustomVectorAccessRandom)->DenseRange(0, 4)->Unit(benchmark::kMillisecond);
+BENCHMARK(benchy::BM_CustomVectorScan)->RangeMultiplier(16)->Range(8 << 10, 32 << 20);
+BENCHMARK(benchy::BM_StdVectorScan)->RangeMultiplier(16)->Range(8 << 10, 32 << 20);
\ No newline at end of file
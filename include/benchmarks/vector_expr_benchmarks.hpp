@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <thread>
+#include "../containers/thread_pool.hpp"
+#include "../containers/vector.hpp"
+#include "../containers/vector_expr.hpp"
+
+namespace benchy {
+    /**
+     * Elementwise float expressions over n-element shared::vectors (arg 0):
+     *
+     * BM_ExprAxpy:        c = a * x + b
+     * BM_ExprPolynomial:  c = (a - b) * (a + b) * x + b
+     *
+     * Arg 1 picks the evaluation: 0 operators that return a new vector per step
+     * (temporaries), 1 a hand-written loop, 2 the fused expression, 3 the expression
+     * evaluated on a thread_pool with one worker per hardware thread.
+     * Bytes processed count the fused pass (every input read once, c written once).
+     */
+
+    namespace naive {
+        using fvec = shared::vector<float>;
+
+        static fvec add(const fvec& a, const fvec& b) {
+            fvec out(a.size());
+            for (size_t i = 0; i < a.size(); i++) out[i] = a[i] + b[i];
+            return out;
+        }
+
+        static fvec sub(const fvec& a, const fvec& b) {
+            fvec out(a.size());
+            for (size_t i = 0; i < a.size(); i++) out[i] = a[i] - b[i];
+            return out;
+        }
+
+        static fvec mul(const fvec& a, const fvec& b) {
+            fvec out(a.size());
+            for (size_t i = 0; i < a.size(); i++) out[i] = a[i] * b[i];
+            return out;
+        }
+
+        static fvec mul(const fvec& a, float x) {
+            fvec out(a.size());
+            for (size_t i = 0; i < a.size(); i++) out[i] = a[i] * x;
+            return out;
+        }
+    }
+
+    struct expr_inputs {
+        shared::vector<float> a, b, c;
+        std::unique_ptr<shared::thread_pool> pool;
+
+        explicit expr_inputs(const benchmark::State& state) {
+            const size_t n = static_cast<size_t>(state.range(0));
+            a.reserve(n);
+            b.reserve(n);
+            for (size_t i = 0; i < n; i++) {
+                a.push_back(static_cast<float>(i % 1000) * 0.001f);
+                b.push_back(static_cast<float>(i % 777) * 0.002f);
+            }
+            c.assign(n, 0.0f);
+            if (state.range(1) == 3) {
+                pool = std::make_unique<shared::thread_pool>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+        }
+    };
+
+    static const char* expr_label(int64_t mode) {
+        static const char* labels[] = {"temporaries", "hand loop", "expression", "expression, pool"};
+        return labels[mode];
+    }
+
+    static void BM_ExprAxpy(benchmark::State& state) {
+        expr_inputs in(state);
+        const auto& a = in.a;
+        const auto& b = in.b;
+        auto& c = in.c;
+        const float x = 1.5f;
+        for (auto _ : state) {
+            switch (state.range(1)) {
+                case 0: c = naive::add(naive::mul(a, x), b); break;
+                case 1:
+                    for (size_t i = 0; i < c.size(); i++) c[i] = a[i] * x + b[i];
+                    break;
+                case 2: c = a * x + b; break;
+                default: shared::evaluate(c, a * x + b, *in.pool); break;
+            }
+            benchmark::DoNotOptimize(c.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * c.size() * 3 * sizeof(float)));
+        state.SetLabel(expr_label(state.range(1)));
+    }
+
+    static void BM_ExprPolynomial(benchmark::State& state) {
+        expr_inputs in(state);
+        const auto& a = in.a;
+        const auto& b = in.b;
+        auto& c = in.c;
+        const float x = 1.5f;
+        for (auto _ : state) {
+            switch (state.range(1)) {
+                case 0: c = naive::add(naive::mul(naive::mul(naive::sub(a, b), naive::add(a, b)), x), b); break;
+                case 1:
+                    for (size_t i = 0; i < c.size(); i++) c[i] = (a[i] - b[i]) * (a[i] + b[i]) * x + b[i];
+                    break;
+                case 2: c = (a - b) * (a + b) * x + b; break;
+                default: shared::evaluate(c, (a - b) * (a + b) * x + b, *in.pool); break;
+            }
+            benchmark::DoNotOptimize(c.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * c.size() * 3 * sizeof(float)));
+        state.SetLabel(expr_label(state.range(1)));
+    }
+}
+
+BENCHMARK(benchy::BM_ExprAxpy)->ArgsProduct({{1 << 12, 1 << 20, 1 << 24}, {0, 1, 2, 3}});
+BENCHMARK(benchy::BM_ExprPolynomial)->ArgsProduct({{1 << 12, 1 << 20, 1 << 24}, {0, 1, 2, 3}});
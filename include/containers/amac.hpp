@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include "prefetch.hpp"
+
+/**
+ * @brief Interleaved (AMAC-style) execution of independent lookups
+ *
+ * Algorithm (Asynchronous Memory Access Chaining, Kocberber et al.):
+ * - Up to G lookups are kept in flight, each as a small state machine
+ * - Every round advances each machine by exactly one step, then prefetches the
+ *   address its next step will touch and moves on to the next machine
+ * - A finished machine reports its result and immediately picks up the next key,
+ *   so the group stays full until the input runs out
+ *
+ * Performance characteristics:
+ * - Sequential lookups over DRAM-resident data pay one full miss per step
+ * - With G machines in flight up to G misses overlap, bounded by the core's
+ *   line fill buffers (typically 10-16), so gains flatten beyond G ~ 16
+ * - For cache-resident data the bookkeeping makes this slower than a plain loop
+ *
+ * Machine interface (see sorted_search below and map::lookup_machine):
+ * - key_type, result_type, and a default-constructible nested state type
+ * - const void* init(state&, const key_type&): prepare a lookup, return first address to touch
+ * - const void* step(state&): advance one step, return next address or nullptr when done
+ * - result_type result(const state&): final answer once step returned nullptr
+ */
+
+namespace shared {
+    static constexpr size_t max_interleave_group = 32;
+
+    /**
+     * @brief Runs machine over keys[0..n) keeping `group` lookups in flight
+     * @param on_result Called as on_result(index, result) in completion order
+     */
+    template <typename Machine, typename OnResult>
+    void interleaved_lookup(const Machine& machine, const typename Machine::key_type* keys, size_t n,
+                            size_t group, OnResult&& on_result) {
+        constexpr size_t idle = static_cast<size_t>(-1);
+        typename Machine::state states[max_interleave_group];
+        size_t owner[max_interleave_group];
+
+        group = group == 0 ? 1 : (group > max_interleave_group ? max_interleave_group : group);
+        if (group > n) group = n;
+
+        size_t next = 0;
+        for (size_t s = 0; s < group; ++s, ++next) {
+            owner[s] = next;
+            if (const void* addr = machine.init(states[s], keys[next])) prefetch(addr);
+        }
+
+        size_t active = group;
+        while (active) {
+            for (size_t s = 0; s < group; ++s) {
+                if (owner[s] == idle) continue;
+
+                if (const void* addr = machine.step(states[s])) {
+                    prefetch(addr);
+                    continue;
+                }
+
+                on_result(owner[s], machine.result(states[s]));
+                if (next < n) {
+                    owner[s] = next;
+                    if (const void* addr = machine.init(states[s], keys[next])) prefetch(addr);
+                    ++next;
+                }
+                else {
+                    owner[s] = idle;
+                    --active;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Lower-bound search over a sorted contiguous range (flat_map layout)
+     * Branch-free halving; each step touches exactly one element
+     */
+    template <typename T, typename Compare = std::less<T>>
+    class sorted_search {
+    private:
+        const T* _data;
+        size_t _size;
+        Compare _comp;
+
+    public:
+        using key_type = T;
+        using result_type = size_t;  // Index of first element not less than key
+
+        struct state {
+            const T* base;
+            size_t len;
+            const T* key;
+        };
+
+        sorted_search(const T* data, size_t size, Compare comp = Compare())
+            : _data(data), _size(size), _comp(comp) {}
+
+        const void* init(state& s, const T& key) const noexcept {
+            s.base = _data;
+            s.len = _size;
+            s.key = &key;
+            return s.len > 1 ? s.base + s.len / 2 : nullptr;
+        }
+
+        const void* step(state& s) const {
+            if (s.len > 1) {
+                size_t half = s.len / 2;
+                if (_comp(s.base[half], *s.key)) s.base += half;
+                s.len -= half;
+                if (s.len > 1) return s.base + s.len / 2;
+            }
+            return nullptr;
+        }
+
+        result_type result(const state& s) const {
+            if (_size == 0) return 0;
+            return static_cast<size_t>(s.base - _data) + (_comp(*s.base, *s.key) ? 1 : 0);
+        }
+    };
+
+    /**
+     * @brief Convenience wrapper: lower_bound indices for a batch of keys
+     */
+    template <typename T, typename Compare = std::less<T>>
+    void lower_bound_batch(const T* data, size_t size, const T* keys, size_t n, size_t* out,
+                           size_t group = 8, Compare comp = Compare()) {
+        sorted_search<T, Compare> machine(data, size, comp);
+        interleaved_lookup(machine, keys, n, group, [out](size_t i, size_t pos) { out[i] = pos; });
+    }
+}
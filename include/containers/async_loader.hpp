@@ -0,0 +1,431 @@
+#pragma once
+#if defined(__unix__) || defined(__APPLE__)
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define SHARED_HAS_IO_URING 1
+#endif
+#endif
+
+/**
+ * @brief Batched loading of serialized shared::vector images from many files
+ *
+ * Image format: 32-byte header (magic, version, element size, count) followed by
+ * the raw elements. save_vector_image/load_vector_image are the synchronous pair.
+ *
+ * Algorithm (load_vector_images):
+ * - io_uring backend (Linux): up to queue_depth files are in flight. Each file is
+ *   opened, sized with fstat and given its destination vector, then one READV
+ *   (header + element array) is queued. Submission and waiting share one
+ *   io_uring_enter; while reads run, the loop opens the next files and validates
+ *   completed ones, so deserialization overlaps I/O
+ * - Fallback (io_uring missing or disabled, non-Linux): one thread_pool task per
+ *   file doing open + pread into the destination vector
+ * - Elements are read straight into the destination buffer, which is allocated
+ *   uninitialized (vector::resize_uninitialized); there is no staging copy or fill pass
+ *
+ * Limitations:
+ * - T must be trivially copyable (images are raw bytes, same endianness and layout)
+ * - The ring is driven through raw syscalls; no SQPOLL, fixed files or registered buffers
+ * - Opens are synchronous on the submitting thread in the io_uring backend
+ * - OS failures throw std::system_error, malformed images std::runtime_error
+ */
+
+namespace shared {
+    namespace detail {
+        struct image_header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t elem_size;
+            uint64_t count;
+            uint64_t reserved;
+        };
+
+        static constexpr uint64_t image_magic = 0x4547414d49594842ull;   // "BHYIMAGE"
+        static constexpr uint32_t image_version = 1;
+
+        [[noreturn]] inline void throw_errno(int err, const std::string& what) {
+            throw std::system_error(err, std::generic_category(), what);
+        }
+
+        inline void pread_full(int fd, void* buf, size_t len, off_t offset, const std::string& path) {
+            char* p = static_cast<char*>(buf);
+            while (len > 0) {
+                ssize_t got = ::pread(fd, p, len, offset);
+                if (got < 0) {
+                    if (errno == EINTR) continue;
+                    throw_errno(errno, "vector image: read " + path);
+                }
+                if (got == 0) throw std::runtime_error("vector image: truncated " + path);
+                p += got;
+                len -= static_cast<size_t>(got);
+                offset += got;
+            }
+        }
+
+        /**
+         * @brief One file being loaded: descriptor, header buffer and destination
+         */
+        template <typename T>
+        struct image_read {
+            int fd = -1;
+            image_header header{};
+            iovec iov[2]{};
+            const std::string* path = nullptr;
+            size_t index = 0;   // Position in the output batch
+
+            /**
+             * @brief Opens path and sizes dst from the file length
+             */
+            void open(const std::string& file, shared::vector<T>& dst) {
+                path = &file;
+                fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) throw_errno(errno, "vector image: open " + file);
+                struct stat st;
+                if (::fstat(fd, &st) != 0) throw_errno(errno, "vector image: fstat " + file);
+                const size_t bytes = static_cast<size_t>(st.st_size);
+                if (bytes < sizeof(image_header) || (bytes - sizeof(image_header)) % sizeof(T) != 0) {
+                    throw std::runtime_error("vector image: bad file size " + file);
+                }
+                // Storage left uninitialized: the read overwrites every element
+                dst.clear();
+                dst.resize_uninitialized((bytes - sizeof(image_header)) / sizeof(T));
+                iov[0] = iovec{&header, sizeof(image_header)};
+                iov[1] = iovec{dst.data(), dst.size() * sizeof(T)};
+            }
+
+            size_t expected() const noexcept { return iov[0].iov_len + iov[1].iov_len; }
+
+            /**
+             * @brief Reads whatever a short read left behind, starting at byte done
+             */
+            void read_rest(size_t done) {
+                off_t offset = static_cast<off_t>(done);
+                for (const iovec& v : iov) {
+                    if (done >= v.iov_len) {
+                        done -= v.iov_len;
+                        continue;
+                    }
+                    pread_full(fd, static_cast<char*>(v.iov_base) + done, v.iov_len - done, offset, *path);
+                    offset += static_cast<off_t>(v.iov_len - done);
+                    done = 0;
+                }
+            }
+
+            void validate(const shared::vector<T>& dst) const {
+                if (header.magic != image_magic || header.version != image_version ||
+                    header.elem_size != sizeof(T) || header.count != dst.size()) {
+                    throw std::runtime_error("vector image: header mismatch " + *path);
+                }
+            }
+
+            void close() noexcept {
+                if (fd >= 0) ::close(fd);
+                fd = -1;
+            }
+
+            ~image_read() { close(); }
+        };
+
+#if defined(SHARED_HAS_IO_URING)
+        /**
+         * @brief Minimal io_uring submission/completion ring over the raw syscalls
+         */
+        class uring {
+        private:
+            int _fd = -1;
+            void* _sq_ring = MAP_FAILED;
+            void* _cq_ring = MAP_FAILED;
+            size_t _sq_ring_bytes = 0;
+            size_t _cq_ring_bytes = 0;
+            io_uring_sqe* _sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+            size_t _sqes_bytes = 0;
+
+            unsigned* _sq_tail = nullptr;
+            unsigned* _sq_mask = nullptr;
+            unsigned* _cq_head = nullptr;
+            unsigned* _cq_tail = nullptr;
+            unsigned* _cq_mask = nullptr;
+            io_uring_cqe* _cqes = nullptr;
+            unsigned _unsubmitted = 0;
+
+        public:
+            uring() = default;
+            uring(const uring&) = delete;
+            uring& operator=(const uring&) = delete;
+
+            /**
+             * @brief Creates the ring; returns false (and leaves errno set) when io_uring is unavailable
+             */
+            bool open(unsigned entries) noexcept {
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+                _fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (_fd < 0) return false;
+
+                _sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                _cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_mmap) _sq_ring_bytes = _cq_ring_bytes = std::max(_sq_ring_bytes, _cq_ring_bytes);
+
+                _sq_ring = ::mmap(nullptr, _sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  _fd, IORING_OFF_SQ_RING);
+                if (_sq_ring == MAP_FAILED) return false;
+                _cq_ring = single_mmap ? _sq_ring
+                    : ::mmap(nullptr, _cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             _fd, IORING_OFF_CQ_RING);
+                if (_cq_ring == MAP_FAILED) return false;
+                _sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+                _sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, _sqes_bytes, PROT_READ | PROT_WRITE,
+                                                          MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES));
+                if (_sqes == MAP_FAILED) return false;
+
+                char* sq = static_cast<char*>(_sq_ring);
+                char* cq = static_cast<char*>(_cq_ring);
+                _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                _sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                _cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+                // SQ slots map one-to-one onto SQEs, so the index array is filled once
+                unsigned* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                for (unsigned i = 0; i < params.sq_entries; ++i) array[i] = i;
+                return true;
+            }
+
+            ~uring() {
+                if (_sqes != MAP_FAILED) ::munmap(_sqes, _sqes_bytes);
+                if (_cq_ring != MAP_FAILED && _cq_ring != _sq_ring) ::munmap(_cq_ring, _cq_ring_bytes);
+                if (_sq_ring != MAP_FAILED) ::munmap(_sq_ring, _sq_ring_bytes);
+                if (_fd >= 0) ::close(_fd);
+            }
+
+            /**
+             * @brief Queues a vectored read; the caller keeps in-flight requests within the ring size
+             */
+            void queue_readv(int fd, const iovec* iov, unsigned count, uint64_t user_data) noexcept {
+                const unsigned tail = *_sq_tail;
+                io_uring_sqe* sqe = &_sqes[tail & *_sq_mask];
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_READV;
+                sqe->fd = fd;
+                sqe->addr = reinterpret_cast<uint64_t>(iov);
+                sqe->len = count;
+                sqe->off = 0;
+                sqe->user_data = user_data;
+                __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+                ++_unsubmitted;
+            }
+
+            /**
+             * @brief Submits queued SQEs and blocks until at least one completion is ready
+             */
+            void submit_and_wait() {
+                for (;;) {
+                    long r = ::syscall(__NR_io_uring_enter, _fd, _unsubmitted, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (r >= 0) {
+                        _unsubmitted -= static_cast<unsigned>(r);
+                        return;
+                    }
+                    if (errno != EINTR) throw_errno(errno, "vector image: io_uring_enter");
+                }
+            }
+
+            /**
+             * @brief Calls fn(user_data, result) for every ready completion
+             */
+            template <typename F>
+            void drain(F&& fn) {
+                unsigned head = *_cq_head;
+                const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head) {
+                    const io_uring_cqe& cqe = _cqes[head & *_cq_mask];
+                    const uint64_t user_data = cqe.user_data;
+                    const int32_t res = cqe.res;
+                    __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+                    fn(user_data, res);
+                }
+            }
+        };
+#endif
+    }
+
+    struct async_load_options {
+        unsigned queue_depth = 64;      // Files in flight on the io_uring backend
+        bool use_io_uring = true;       // false forces the thread pool fallback
+        thread_pool* pool = nullptr;    // Fallback workers; a private pool is created when null
+        size_t fallback_threads = 8;    // Size of the private fallback pool
+    };
+
+    struct async_load_stats {
+        size_t files = 0;
+        size_t bytes = 0;
+        bool io_uring = false;          // Backend that served the load
+    };
+
+    /**
+     * @brief Writes vec to path as a vector image (header + raw elements)
+     */
+    template <typename T>
+    void save_vector_image(const std::string& path, const shared::vector<T>& vec) {
+        static_assert(std::is_trivially_copyable_v<T>, "vector images hold trivially copyable elements");
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) detail::throw_errno(errno, "vector image: open " + path);
+
+        detail::image_header header{detail::image_magic, detail::image_version, sizeof(T), vec.size(), 0};
+        iovec iov[2] = {{&header, sizeof(header)},
+                        {const_cast<T*>(vec.data()), vec.size() * sizeof(T)}};
+        size_t left = iov[0].iov_len + iov[1].iov_len;
+        int first = 0;
+        while (left > 0) {
+            ssize_t put = ::writev(fd, iov + first, 2 - first);
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                int err = errno;
+                ::close(fd);
+                detail::throw_errno(err, "vector image: write " + path);
+            }
+            left -= static_cast<size_t>(put);
+            size_t done = static_cast<size_t>(put);
+            while (first < 2 && done >= iov[first].iov_len) done -= iov[first++].iov_len;
+            if (first < 2) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + done;
+                iov[first].iov_len -= done;
+            }
+        }
+        ::close(fd);
+    }
+
+    /**
+     * @brief Synchronously reads one vector image (open, fstat, read header and elements)
+     */
+    template <typename T>
+    shared::vector<T> load_vector_image(const std::string& path) {
+        static_assert(std::is_trivially_copyable_v<T>, "vector images hold trivially copyable elements");
+        shared::vector<T> out;
+        detail::image_read<T> req;
+        req.open(path, out);
+        req.read_rest(0);
+        req.validate(out);
+        return out;
+    }
+
+    /**
+     * @brief Loads one vector image per path, keeping many reads in flight
+     * @return Vectors in the order of paths
+     */
+    template <typename T>
+    shared::vector<shared::vector<T>> load_vector_images(const std::vector<std::string>& paths,
+                                                         const async_load_options& options = {},
+                                                         async_load_stats* stats = nullptr) {
+        static_assert(std::is_trivially_copyable_v<T>, "vector images hold trivially copyable elements");
+        const size_t n = paths.size();
+        shared::vector<shared::vector<T>> out(n);
+        bool used_io_uring = false;
+
+#if defined(SHARED_HAS_IO_URING)
+        detail::uring ring;
+        const unsigned depth = std::max(1u, options.queue_depth);
+        if (options.use_io_uring && n > 0 && ring.open(depth)) {
+            used_io_uring = true;
+            std::vector<detail::image_read<T>> slots(depth);
+            std::vector<unsigned> free_slots(depth);
+            for (unsigned i = 0; i < depth; ++i) free_slots[i] = depth - 1 - i;
+
+            // On error, stop submitting but keep draining: the kernel still owns the in-flight buffers
+            std::exception_ptr error;
+            size_t next = 0;
+            size_t inflight = 0;
+            while (inflight > 0 || (!error && next < n)) {
+                while (!error && next < n && !free_slots.empty()) {
+                    const unsigned s = free_slots.back();
+                    try {
+                        slots[s].open(paths[next], out[next]);
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                        slots[s].close();
+                        break;
+                    }
+                    free_slots.pop_back();
+                    slots[s].index = next;
+                    ring.queue_readv(slots[s].fd, slots[s].iov, 2, s);
+                    ++next;
+                    ++inflight;
+                }
+                if (inflight == 0) break;
+
+                ring.submit_and_wait();
+                ring.drain([&](uint64_t user_data, int32_t res) {
+                    const unsigned s = static_cast<unsigned>(user_data);
+                    detail::image_read<T>& req = slots[s];
+                    const size_t index = req.index;
+                    if (!error) {
+                        try {
+                            if (res < 0) detail::throw_errno(-res, "vector image: read " + paths[index]);
+                            if (static_cast<size_t>(res) < req.expected()) req.read_rest(static_cast<size_t>(res));
+                            req.validate(out[index]);
+                        }
+                        catch (...) {
+                            error = std::current_exception();
+                        }
+                    }
+                    req.close();
+                    free_slots.push_back(s);
+                    --inflight;
+                });
+            }
+            if (error) std::rethrow_exception(error);
+        }
+#endif
+
+        if (!used_io_uring && n > 0) {
+            std::unique_ptr<thread_pool> own_pool;
+            thread_pool* pool = options.pool;
+            if (!pool) {
+                own_pool = std::make_unique<thread_pool>(std::min(options.fallback_threads, n));
+                pool = own_pool.get();
+            }
+            pool->parallel_for(n, [&](size_t i) {
+                detail::image_read<T> req;
+                req.open(paths[i], out[i]);
+                req.read_rest(0);
+                req.validate(out[i]);
+            });
+        }
+
+        if (stats) {
+            stats->files = n;
+            stats->bytes = 0;
+            for (size_t i = 0; i < n; ++i) stats->bytes += sizeof(detail::image_header) + out[i].size() * sizeof(T);
+            stats->io_uring = used_io_uring;
+        }
+        return out;
+    }
+}
+#endif
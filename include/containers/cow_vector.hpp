@@ -0,0 +1,209 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include "vector.hpp"
+
+/**
+ * @brief Copy-on-write vector: copies share one reference-counted shared::vector until
+ * one of them is written
+ *
+ * Performance characteristics:
+ * - Copying is O(1): one atomic increment, no allocation or element copies
+ * - Reads (operator[], data(), begin()/end(), get()) are const and never copy
+ * - The first mutation through a copy whose storage is shared deep-copies it once
+ *   (bulk copy from vector, non-temporal above streaming::threshold()); later
+ *   mutations only check the reference count (one acquire load). The copy keeps the
+ *   storage's alloc_options and deleter
+ * - clear() and assignment of shared storage drop the reference without copying
+ *
+ * Mutation is explicit (mutable_at, mutable_data, set, push_back, resize, ...), so a
+ * non-const object can be read without detaching, unlike a non-const operator[]
+ *
+ * Thread safety matches std::shared_ptr: distinct cow_vector objects that share storage
+ * may be used from different threads (the count is atomic, the shared elements are
+ * never written), but one object needs external synchronization
+ *
+ * Limitations:
+ * - References and pointers from mutable_at/mutable_data stay writable after *this is
+ *   copied, and writes through them would then show in the copy; take them again
+ *   after copying
+ */
+
+namespace shared {
+    template<class T>
+    class cow_vector {
+    private:
+        struct shared_block {
+            std::atomic<size_t> refs;
+            vector<T> elements;
+
+            explicit shared_block(vector<T>&& v) : refs(1), elements(std::move(v)) {}
+        };
+
+        shared_block* _block;   // Storage shared with copies; nullptr while empty and never written
+
+        void release() noexcept {
+            if (_block && _block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete _block;
+            }
+            _block = nullptr;
+        }
+
+        /**
+         * @brief Makes this the only owner of its storage, deep-copying it if shared
+         * @param extra Spare capacity for a copy, so a following append does not reallocate
+         */
+        vector<T>& unique(size_t extra = 0) {
+            if (!_block) {
+                _block = new shared_block(vector<T>());
+            }
+            else if (_block->refs.load(std::memory_order_acquire) != 1) {
+                const vector<T>& src = _block->elements;
+                vector<T> copy(src.alloc(), src.deleter());
+                copy.reserve(src.size() + extra);
+                copy.assign(src.data(), src.size());
+                shared_block* fresh = new shared_block(std::move(copy));
+                release();
+                _block = fresh;
+            }
+            return _block->elements;
+        }
+
+        static const vector<T>& empty_vector() {
+            static const vector<T> empty;
+            return empty;
+        }
+
+    public:
+        cow_vector() noexcept : _block(nullptr) {}
+
+        explicit cow_vector(size_t n, const T& val = T()) : _block(nullptr) {
+            if (n > 0) {
+                vector<T> v;
+                v.assign(n, val);
+                _block = new shared_block(std::move(v));
+            }
+        }
+
+        cow_vector(std::initializer_list<T> init) : _block(nullptr) {
+            if (init.size() > 0) {
+                vector<T> v;
+                v.assign(init.begin(), init.size());
+                _block = new shared_block(std::move(v));
+            }
+        }
+
+        /**
+         * @brief Takes over v's storage without copying
+         */
+        explicit cow_vector(vector<T>&& v) : _block(new shared_block(std::move(v))) {}
+
+        /**
+         * @brief Shares other's storage (one atomic increment)
+         */
+        cow_vector(const cow_vector& other) noexcept : _block(other._block) {
+            if (_block) _block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        cow_vector(cow_vector&& other) noexcept : _block(other._block) {
+            other._block = nullptr;
+        }
+
+        cow_vector& operator=(const cow_vector& other) noexcept {
+            if (_block != other._block) {
+                if (other._block) other._block->refs.fetch_add(1, std::memory_order_relaxed);
+                release();
+                _block = other._block;
+            }
+            return *this;
+        }
+
+        cow_vector& operator=(cow_vector&& other) noexcept {
+            if (this != &other) {
+                release();
+                _block = other._block;
+                other._block = nullptr;
+            }
+            return *this;
+        }
+
+        ~cow_vector() {
+            release();
+        }
+
+        // Reads: const, never copy
+        size_t size() const noexcept { return _block ? _block->elements.size() : 0; }
+        bool empty() const noexcept { return size() == 0; }
+        const T* data() const noexcept { return _block ? _block->elements.data() : nullptr; }
+        const T& operator[](size_t i) const { return _block->elements[i]; }
+        const T& front() const { return _block->elements.front(); }
+        const T& back() const { return _block->elements.back(); }
+        const T* begin() const noexcept { return data(); }
+        const T* end() const noexcept { return data() + size(); }
+
+        /**
+         * @brief The underlying vector, for APIs that take const vector<T>&
+         */
+        const vector<T>& get() const { return _block ? _block->elements : empty_vector(); }
+
+        /**
+         * @brief Number of cow_vectors sharing this storage (0 when there is none)
+         */
+        size_t use_count() const noexcept {
+            return _block ? _block->refs.load(std::memory_order_acquire) : 0;
+        }
+
+        bool shares_storage_with(const cow_vector& other) const noexcept {
+            return _block != nullptr && _block == other._block;
+        }
+
+        // Mutations: copy shared storage first. Each call loads the reference count,
+        // which keeps loops over mutable_at from vectorizing; take mutable_data() once
+        // for bulk writes
+        T& mutable_at(size_t i) { return unique()[i]; }
+        T* mutable_data() { return unique().data(); }
+
+        void set(size_t i, T value) { unique()[i] = std::move(value); }
+
+        void push_back(const T& val) {
+            vector<T>& v = unique(1);
+            v.push_back(val);
+        }
+
+        void push_back(T&& val) {
+            vector<T>& v = unique(1);
+            v.push_back(std::move(val));
+        }
+
+        void reserve(size_t n) {
+            unique(n > size() ? n - size() : 0).reserve(n);
+        }
+
+        void resize(size_t n, const T& val = T()) {
+            unique(n > size() ? n - size() : 0).resize(n, val);
+        }
+
+        /**
+         * @brief Empties this vector; shared storage is released, not copied
+         */
+        void clear() {
+            if (_block && _block->refs.load(std::memory_order_acquire) == 1) {
+                _block->elements.clear();
+            } else {
+                release();
+            }
+        }
+
+        /**
+         * @brief Moves the elements out as a vector, copying only if the storage is shared
+         */
+        vector<T> take() {
+            if (!_block) return vector<T>();
+            vector<T> out(std::move(unique()));
+            release();
+            return out;
+        }
+    };
+}
@@ -0,0 +1,622 @@
+#pragma once
+#if defined(__unix__) || defined(__APPLE__)
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "hash.hpp"
+#include "map.hpp"
+
+/**
+ * @brief Larger-than-RAM hash table: 4 KB bucket pages in a file behind a CLOCK page cache
+ *
+ * File layout:
+ * - Page 0: header (magic, version, key/value sizes, slots per page, page count,
+ *   element count, global depth, directory offset)
+ * - Pages 1..N: buckets. Each holds a depth, an element count, one tag byte per slot
+ *   (0 = empty, else 7 hash bits | 0x80) and the key and value arrays
+ * - The directory (page number per hash prefix) is written after the last page on flush
+ *
+ * Algorithm:
+ * - Extendible hashing like segmented_map: the fmix64-finalized hash's top global_depth
+ *   bits index an in-memory directory, so a lookup reads at most one page
+ * - Inside a page, linear probing from a home slot picked by the low hash bits; the tag
+ *   byte filters slots before a key compare. map.hpp's triangular step is not reused:
+ *   it only covers every slot of a power-of-two table, and a page holds whatever fits
+ *   in 4 KB (240 u64 -> u64 slots). The page is resident by then, and a linear walk
+ *   reads the one-byte tags sequentially, so even long probes near the 7/8 split
+ *   bound stay within a few cache lines of tags
+ * - A page about to pass 7/8 full splits into itself and one new page appended to the file
+ * - Page cache: a fixed number of 4 KB frames with CLOCK (second chance) eviction; a
+ *   frame table indexed by page number finds resident pages without hashing
+ * - Evicting a dirty frame writes it back together with other dirty frames ahead of the
+ *   clock hand, sorted by page number, adjacent pages coalesced into one pwritev
+ *
+ * Performance characteristics:
+ * - Hits cost a directory read and an in-memory probe; misses one pread (plus, rarely,
+ *   a batched writeback)
+ * - With direct_io (O_DIRECT, Linux) misses go to the device; otherwise they may be
+ *   served by the OS page cache, which then duplicates the frames
+ *
+ * Limitations:
+ * - Keys and values must be trivially copyable; no erase
+ * - Not crash-safe: evictions write pages in place, and the directory and header only
+ *   describe the table after flush() (called by the destructor) completes
+ * - Not thread-safe
+ * - OS failures throw std::system_error; malformed files std::runtime_error
+ */
+
+namespace shared {
+    struct disk_map_options {
+        size_t cache_bytes = size_t(64) << 20;  // Page cache budget (at least two pages)
+        size_t writeback_batch = 32;            // Dirty pages written per eviction writeback
+        bool direct_io = false;                 // O_DIRECT where the file system supports it
+    };
+
+    struct disk_map_stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t page_reads = 0;
+        uint64_t page_writes = 0;
+        uint64_t write_calls = 0;  // pwrite/pwritev calls issued for page writes
+    };
+
+    template <typename k, typename v, typename Hash = hasher<k>>
+    class disk_map {
+        static_assert(std::is_trivially_copyable_v<k> && std::is_trivially_copyable_v<v>,
+                      "disk_map keys and values must be trivially copyable");
+
+    public:
+        static constexpr size_t page_bytes = 4096;
+
+    private:
+        struct header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t key_size;
+            uint32_t value_size;
+            uint32_t slots;
+            uint64_t page_count;   // Bucket pages, excluding the header page
+            uint64_t size;
+            uint32_t global_depth;
+            uint32_t reserved;
+            uint64_t directory_offset;
+        };
+
+        struct page_header {
+            uint32_t depth;
+            uint32_t count;
+        };
+
+        struct frame {
+            uint32_t page;  // npos when free
+            bool dirty;
+            bool referenced;
+        };
+
+        static constexpr uint64_t file_magic = 0x50414d4b53494442ull;  // "BDISKMAP"
+        static constexpr uint32_t file_version = 1;
+        static constexpr uint32_t npos = UINT32_MAX;
+        static constexpr uint32_t max_depth = 26;
+        static constexpr size_t slots = (page_bytes - sizeof(page_header)) / (1 + sizeof(k) + sizeof(v));
+        static constexpr size_t max_fill = slots / 8 * 7;
+        static constexpr size_t tags_offset = sizeof(page_header);
+        static constexpr size_t keys_offset = tags_offset + slots;
+        static constexpr size_t values_offset = keys_offset + slots * sizeof(k);
+        static_assert(slots >= 8, "disk_map entries must fit at least 8 per 4 KB page");
+
+        int _fd;
+        bool _direct;
+        std::vector<uint32_t> _directory;
+        uint32_t _global_depth;
+        uint64_t _page_count;
+        uint64_t _size;
+        Hash _hash;
+
+        char* _frames;                    // frame_count * page_bytes, page aligned
+        std::vector<frame> _frame_meta;
+        std::vector<uint32_t> _frame_of;  // Page number -> frame, npos when not resident
+        size_t _hand;
+        size_t _writeback_batch;
+        disk_map_stats _stats;
+
+        [[noreturn]] static void fail(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        static char* aligned_buffer(size_t bytes) {
+            void* p = nullptr;
+            if (::posix_memalign(&p, page_bytes, bytes) != 0) throw std::bad_alloc();
+            return static_cast<char*>(p);
+        }
+
+        static size_t round_to_page(size_t bytes) noexcept {
+            return (bytes + page_bytes - 1) / page_bytes * page_bytes;
+        }
+
+        static off_t page_offset(uint64_t page) noexcept {
+            return static_cast<off_t>(page * page_bytes);
+        }
+
+        static size_t top_bits(uint64_t hash, uint32_t bits) noexcept {
+            return bits ? static_cast<size_t>(hash >> (64 - bits)) : 0;
+        }
+
+        uint64_t hash_key(const k& key) const noexcept {
+            return hashes::fmix64(static_cast<uint64_t>(_hash(key)));
+        }
+
+        static uint8_t tag_of(uint64_t hash) noexcept {
+            return static_cast<uint8_t>((hash & 0x7f) | 0x80);
+        }
+
+        static size_t home_slot(uint64_t hash) noexcept {
+            return static_cast<size_t>(((hash >> 8) & 0xffffffffu) * slots >> 32);
+        }
+
+        static page_header& page_hdr(char* page) noexcept {
+            return *reinterpret_cast<page_header*>(page);
+        }
+
+        static k key_at(const char* page, size_t slot) noexcept {
+            k key;
+            std::memcpy(&key, page + keys_offset + slot * sizeof(k), sizeof(k));
+            return key;
+        }
+
+        static v value_at(const char* page, size_t slot) noexcept {
+            v value;
+            std::memcpy(&value, page + values_offset + slot * sizeof(v), sizeof(v));
+            return value;
+        }
+
+        static void put(char* page, size_t slot, uint8_t tag, const k& key, const v& value) noexcept {
+            page[tags_offset + slot] = static_cast<char>(tag);
+            std::memcpy(page + keys_offset + slot * sizeof(k), &key, sizeof(k));
+            std::memcpy(page + values_offset + slot * sizeof(v), &value, sizeof(v));
+        }
+
+        /**
+         * @brief Slot holding key, or the empty slot where it belongs
+         * Linear rather than map's triangular probing: slots is not a power of two
+         */
+        static size_t find_slot(const char* page, const k& key, uint64_t hash) noexcept {
+            const uint8_t tag = tag_of(hash);
+            size_t slot = home_slot(hash);
+            for (;;) {
+                const uint8_t t = static_cast<uint8_t>(page[tags_offset + slot]);
+                if (t == 0 || (t == tag && key_at(page, slot) == key)) {
+                    return slot;
+                }
+                if (++slot == slots) slot = 0;
+            }
+        }
+
+        // Page I/O
+
+        void read_page(uint64_t page, char* buffer) {
+            size_t done = 0;
+            while (done < page_bytes) {
+                const ssize_t n = ::pread(_fd, buffer + done, page_bytes - done, page_offset(page) + static_cast<off_t>(done));
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    fail("disk_map: pread");
+                }
+                if (n == 0) throw std::runtime_error("disk_map: page past end of file");
+                done += static_cast<size_t>(n);
+            }
+            _stats.page_reads++;
+        }
+
+        /**
+         * @brief pwritev that resumes after partial writes; advances iov in place
+         */
+        void write_full(struct iovec* iov, int count, off_t offset) {
+            while (count > 0) {
+                const ssize_t n = ::pwritev(_fd, iov, count, offset);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    fail("disk_map: pwritev");
+                }
+                _stats.write_calls++;
+                offset += n;
+                size_t done = static_cast<size_t>(n);
+                while (count > 0 && done >= iov->iov_len) {
+                    done -= iov->iov_len;
+                    ++iov;
+                    --count;
+                }
+                if (count > 0) {
+                    iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+                    iov->iov_len -= done;
+                }
+            }
+        }
+
+        /**
+         * @brief Writes the given dirty frames sorted by page, coalescing adjacent pages
+         */
+        void write_frames(std::vector<size_t>& batch) {
+            std::sort(batch.begin(), batch.end(), [this](size_t a, size_t b) {
+                return _frame_meta[a].page < _frame_meta[b].page;
+            });
+            constexpr int max_iov = 64;
+            struct iovec iov[max_iov];
+            for (size_t i = 0; i < batch.size(); ) {
+                const uint32_t first = _frame_meta[batch[i]].page;
+                int count = 0;
+                while (i < batch.size() && count < max_iov && _frame_meta[batch[i]].page == first + static_cast<uint32_t>(count)) {
+                    iov[count].iov_base = _frames + batch[i] * page_bytes;
+                    iov[count].iov_len = page_bytes;
+                    _frame_meta[batch[i]].dirty = false;
+                    count++;
+                    i++;
+                }
+                write_full(iov, count, page_offset(first));
+                _stats.page_writes += static_cast<uint64_t>(count);
+            }
+        }
+
+        /**
+         * @brief Writes back frame f with up to writeback_batch - 1 dirty frames ahead of it
+         */
+        void write_back_from(size_t f) {
+            std::vector<size_t> batch;
+            batch.reserve(_writeback_batch);
+            for (size_t i = 0; i < _frame_meta.size() && batch.size() < _writeback_batch; i++) {
+                const size_t g = (f + i) % _frame_meta.size();
+                if (_frame_meta[g].page != npos && _frame_meta[g].dirty) batch.push_back(g);
+            }
+            write_frames(batch);
+        }
+
+        // Page cache
+
+        size_t victim() {
+            for (;;) {
+                frame& fr = _frame_meta[_hand];
+                const size_t f = _hand;
+                _hand = (_hand + 1) % _frame_meta.size();
+                if (fr.page == npos) return f;
+                if (fr.referenced) {
+                    fr.referenced = false;
+                    continue;
+                }
+                if (fr.dirty) write_back_from(f);
+                _frame_of[fr.page] = npos;
+                fr.page = npos;
+                return f;
+            }
+        }
+
+        /**
+         * @brief Frame holding page, reading it on a miss (or zeroing it when fresh)
+         */
+        char* fetch(uint32_t page, bool fresh = false) {
+            const uint32_t resident = _frame_of[page];
+            if (resident != npos) {
+                _stats.hits++;
+                _frame_meta[resident].referenced = true;
+                return _frames + resident * page_bytes;
+            }
+            _stats.misses += !fresh;
+            const size_t f = victim();
+            char* buffer = _frames + f * page_bytes;
+            if (fresh) {
+                std::memset(buffer, 0, page_bytes);
+            } else {
+                read_page(page, buffer);
+            }
+            _frame_meta[f] = frame{page, fresh, true};
+            _frame_of[page] = static_cast<uint32_t>(f);
+            return buffer;
+        }
+
+        void mark_dirty(uint32_t page) noexcept {
+            _frame_meta[_frame_of[page]].dirty = true;
+        }
+
+        uint32_t append_page() {
+            if (_page_count + 1 >= npos) throw std::length_error("disk_map: page numbers exhausted");
+            const uint32_t page = static_cast<uint32_t>(++_page_count);
+            _frame_of.push_back(npos);
+            return page;
+        }
+
+        /**
+         * @brief Splits the page behind hash's directory entry into itself and a new page
+         */
+        void split(uint64_t hash) {
+            const uint32_t old_page = _directory[top_bits(hash, _global_depth)];
+            alignas(16) char scratch[page_bytes];
+            std::memcpy(scratch, fetch(old_page), page_bytes);
+            const uint32_t depth = page_hdr(scratch).depth;
+
+            if (depth == _global_depth) {
+                uint64_t diff = 0;
+                for (size_t s = 0; s < slots; s++) {
+                    if (scratch[tags_offset + s]) diff |= hash_key(key_at(scratch, s)) ^ hash;
+                }
+                if ((diff >> (64 - max_depth)) == 0) {
+                    throw std::length_error("disk_map: page keys do not separate within the directory depth limit");
+                }
+                std::vector<uint32_t> doubled(_directory.size() * 2);
+                for (size_t i = 0; i < _directory.size(); i++) {
+                    doubled[2 * i] = doubled[2 * i + 1] = _directory[i];
+                }
+                _directory.swap(doubled);
+                _global_depth++;
+            }
+
+            const uint32_t new_page = append_page();
+            char* pages[2];
+            // Each fetch may evict the other page's frame, so fill one page at a time
+            for (int side = 1; side >= 0; side--) {
+                pages[side] = side ? fetch(new_page, true) : fetch(old_page);
+                std::memset(pages[side], 0, page_bytes);
+                page_hdr(pages[side]).depth = depth + 1;
+                for (size_t s = 0; s < slots; s++) {
+                    if (!scratch[tags_offset + s]) continue;
+                    const k key = key_at(scratch, s);
+                    const uint64_t h = hash_key(key);
+                    if (static_cast<int>((h >> (63 - depth)) & 1) != side) continue;
+                    put(pages[side], find_slot(pages[side], key, h), tag_of(h), key, value_at(scratch, s));
+                    page_hdr(pages[side]).count++;
+                }
+                mark_dirty(side ? new_page : old_page);
+            }
+
+            const size_t span = size_t(1) << (_global_depth - depth);
+            const size_t first = top_bits(hash, depth) * span;
+            for (size_t i = span / 2; i < span; i++) {
+                _directory[first + i] = new_page;
+            }
+        }
+
+        void write_metadata() {
+            const size_t dir_bytes = round_to_page(_directory.size() * sizeof(uint32_t));
+            const uint64_t dir_offset = (_page_count + 1) * page_bytes;
+            char* buffer = aligned_buffer(std::max(dir_bytes, page_bytes));
+            try {
+                std::memset(buffer, 0, dir_bytes);
+                std::memcpy(buffer, _directory.data(), _directory.size() * sizeof(uint32_t));
+                struct iovec iov{buffer, dir_bytes};
+                write_full(&iov, 1, static_cast<off_t>(dir_offset));
+
+                std::memset(buffer, 0, page_bytes);
+                header h{file_magic, file_version, sizeof(k), sizeof(v), static_cast<uint32_t>(slots),
+                         _page_count, _size, _global_depth, 0, dir_offset};
+                std::memcpy(buffer, &h, sizeof(h));
+                iov = {buffer, page_bytes};
+                write_full(&iov, 1, 0);
+            } catch (...) {
+                std::free(buffer);
+                throw;
+            }
+            std::free(buffer);
+        }
+
+        void create() {
+            _global_depth = 0;
+            _page_count = 0;
+            _size = 0;
+            _frame_of.assign(1, npos);  // Page 0 is the header
+            _directory.assign(1, append_page());
+            fetch(_directory[0], true);
+        }
+
+        void load() {
+            char* buffer = aligned_buffer(page_bytes);
+            header h;
+            try {
+                read_page(0, buffer);
+                std::memcpy(&h, buffer, sizeof(h));
+            } catch (...) {
+                std::free(buffer);
+                throw;
+            }
+            std::free(buffer);
+            if (h.magic != file_magic || h.version != file_version || h.key_size != sizeof(k) ||
+                h.value_size != sizeof(v) || h.slots != slots || h.global_depth > max_depth) {
+                throw std::runtime_error("disk_map: header mismatch");
+            }
+            _global_depth = h.global_depth;
+            _page_count = h.page_count;
+            _size = h.size;
+            _frame_of.assign(_page_count + 1, npos);
+
+            const size_t entries = size_t(1) << _global_depth;
+            const size_t dir_bytes = round_to_page(entries * sizeof(uint32_t));
+            char* dir = aligned_buffer(dir_bytes);
+            try {
+                for (size_t p = 0; p < dir_bytes / page_bytes; p++) {
+                    read_page(h.directory_offset / page_bytes + p, dir + p * page_bytes);
+                }
+                _directory.resize(entries);
+                std::memcpy(_directory.data(), dir, entries * sizeof(uint32_t));
+            } catch (...) {
+                std::free(dir);
+                throw;
+            }
+            std::free(dir);
+            for (uint32_t page : _directory) {
+                if (page == 0 || page > _page_count) throw std::runtime_error("disk_map: directory entry out of range");
+            }
+            _stats = disk_map_stats();
+        }
+
+        void release() noexcept {
+            if (_fd >= 0) {
+                try {
+                    flush();
+                } catch (...) {
+                }
+                ::close(_fd);
+                _fd = -1;
+            }
+            std::free(_frames);
+            _frames = nullptr;
+        }
+
+    public:
+        /**
+         * @brief Opens path, creating an empty table if the file is missing or empty
+         */
+        explicit disk_map(const std::string& path, const disk_map_options& options = disk_map_options())
+            : _fd(-1), _direct(false), _global_depth(0), _page_count(0), _size(0), _frames(nullptr),
+              _hand(0), _writeback_batch(std::max<size_t>(options.writeback_batch, 1))
+        {
+            int flags = O_RDWR | O_CREAT;
+#if defined(__linux__) && defined(O_DIRECT)
+            if (options.direct_io) {
+                _fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+                _direct = _fd >= 0;
+            }
+#endif
+            if (_fd < 0) _fd = ::open(path.c_str(), flags, 0644);
+            if (_fd < 0) fail("disk_map: open");
+
+            try {
+                const size_t frame_count = std::max<size_t>(options.cache_bytes / page_bytes, 2);
+                _frames = aligned_buffer(frame_count * page_bytes);
+                _frame_meta.assign(frame_count, frame{npos, false, false});
+
+                struct stat st;
+                if (::fstat(_fd, &st) != 0) fail("disk_map: fstat");
+                if (st.st_size == 0) {
+                    create();
+                } else {
+                    load();
+                }
+            } catch (...) {
+                std::free(_frames);
+                ::close(_fd);
+                throw;
+            }
+        }
+
+        /**
+         * @brief Flushes (best effort) and closes; call flush() first to observe errors
+         */
+        ~disk_map() {
+            release();
+        }
+
+        disk_map(disk_map&& other) noexcept
+            : _fd(std::exchange(other._fd, -1)), _direct(other._direct)
+            , _directory(std::move(other._directory)), _global_depth(other._global_depth)
+            , _page_count(other._page_count), _size(other._size), _hash(std::move(other._hash))
+            , _frames(std::exchange(other._frames, nullptr)), _frame_meta(std::move(other._frame_meta))
+            , _frame_of(std::move(other._frame_of)), _hand(other._hand)
+            , _writeback_batch(other._writeback_batch), _stats(other._stats) {}
+
+        disk_map& operator=(disk_map&& other) noexcept {
+            if (this != &other) {
+                release();
+                _fd = std::exchange(other._fd, -1);
+                _direct = other._direct;
+                _directory = std::move(other._directory);
+                _global_depth = other._global_depth;
+                _page_count = other._page_count;
+                _size = other._size;
+                _hash = std::move(other._hash);
+                _frames = std::exchange(other._frames, nullptr);
+                _frame_meta = std::move(other._frame_meta);
+                _frame_of = std::move(other._frame_of);
+                _hand = other._hand;
+                _writeback_batch = other._writeback_batch;
+                _stats = other._stats;
+            }
+            return *this;
+        }
+
+        disk_map(const disk_map&) = delete;
+        disk_map& operator=(const disk_map&) = delete;
+
+        /**
+         * @brief Stores value under key
+         * @return True if key was new
+         */
+        bool insert_or_assign(const k& key, const v& value) {
+            const uint64_t hash = hash_key(key);
+            for (;;) {
+                const uint32_t page = _directory[top_bits(hash, _global_depth)];
+                char* p = fetch(page);
+                const size_t slot = find_slot(p, key, hash);
+                if (p[tags_offset + slot]) {
+                    std::memcpy(p + values_offset + slot * sizeof(v), &value, sizeof(v));
+                    mark_dirty(page);
+                    return false;
+                }
+                if (page_hdr(p).count + 1 > max_fill) {
+                    split(hash);
+                    continue;
+                }
+                put(p, slot, tag_of(hash), key, value);
+                page_hdr(p).count++;
+                mark_dirty(page);
+                _size++;
+                return true;
+            }
+        }
+
+        /**
+         * @brief Copy of the value stored under key; at most one page read
+         */
+        std::optional<v> find(const k& key) {
+            const uint64_t hash = hash_key(key);
+            const char* p = fetch(_directory[top_bits(hash, _global_depth)]);
+            const size_t slot = find_slot(p, key, hash);
+            if (p[tags_offset + slot]) return value_at(p, slot);
+            return std::nullopt;
+        }
+
+        bool contains(const k& key) {
+            return find(key).has_value();
+        }
+
+        /**
+         * @brief Writes every dirty page (batched, sorted), then the directory and header
+         * @param durable Also fdatasync the file
+         */
+        void flush(bool durable = false) {
+            std::vector<size_t> dirty;
+            for (size_t f = 0; f < _frame_meta.size(); f++) {
+                if (_frame_meta[f].page != npos && _frame_meta[f].dirty) dirty.push_back(f);
+            }
+            write_frames(dirty);
+            write_metadata();
+#if defined(__linux__)
+            if (durable && ::fdatasync(_fd) != 0) fail("disk_map: fdatasync");
+#else
+            if (durable && ::fsync(_fd) != 0) fail("disk_map: fsync");
+#endif
+        }
+
+        size_t size() const noexcept { return static_cast<size_t>(_size); }
+        bool empty() const noexcept { return _size == 0; }
+        size_t page_count() const noexcept { return static_cast<size_t>(_page_count); }
+        size_t cache_pages() const noexcept { return _frame_meta.size(); }
+        size_t file_bytes() const noexcept { return static_cast<size_t>(_page_count + 1) * page_bytes; }
+        uint32_t depth() const noexcept { return _global_depth; }
+        bool direct_io() const noexcept { return _direct; }
+        static constexpr size_t slots_per_page() noexcept { return slots; }
+
+        const disk_map_stats& stats() const noexcept { return _stats; }
+        void reset_stats() noexcept { _stats = disk_map_stats(); }
+    };
+}
+#endif
@@ -0,0 +1,533 @@
+#pragma once
+#if defined(__unix__) || defined(__APPLE__)
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief External-memory sort of a file of fixed-size records larger than RAM
+ *
+ * Algorithm:
+ * - Run formation: the input is read in chunks sized to the memory budget, each
+ *   chunk is sorted in memory (LSD radix sort for unsigned integer keys under
+ *   std::less, std::sort otherwise) and written out as a sorted run
+ * - Double buffering: while one sorted chunk is being written by a background
+ *   task, the next chunk is read and sorted in the other buffer
+ * - Merge: runs are combined with a k-way loser tree (one comparison per level per
+ *   output element). Each run reader keeps two blocks, consuming one while the
+ *   next is read ahead asynchronously; the output is double-buffered the same way
+ * - When the budget cannot hold two blocks for every run, extra merge passes
+ *   reduce the run count to the affordable fan-in first
+ *
+ * I/O:
+ * - Run files can use O_DIRECT (bypassing the page cache, so the sort does not
+ *   evict the rest of the machine's working set). Blocks are 4 KB aligned and the
+ *   last block is padded. Filesystems that reject O_DIRECT (tmpfs) fall back to buffered I/O
+ * - Input and output are plain record files; temp runs are removed when done, and
+ *   temp runs, merge outputs and the partial output are removed when the sort fails
+ *
+ * Limitations:
+ * - Records must be trivially copyable; ordering is not stable
+ * - POSIX only; OS failures are reported by throwing std::system_error, an input
+ *   that is not a whole number of records by std::runtime_error
+ */
+
+namespace shared {
+    struct external_sort_options {
+        size_t memory_budget = size_t(64) << 20;  // Bytes for sort buffers or merge blocks
+        std::string temp_dir;                     // Empty: std::filesystem::temp_directory_path()
+        bool direct_io = false;                   // O_DIRECT for temporary run files
+        bool use_radix = true;                    // Radix sort runs when keys allow it
+    };
+
+    struct external_sort_stats {
+        size_t records = 0;
+        size_t runs = 0;           // Sorted runs produced by run formation
+        size_t merge_passes = 0;   // Merge passes, including the final one
+        bool direct_io = false;    // Whether run files actually used O_DIRECT
+    };
+
+    namespace detail {
+        static constexpr size_t io_alignment = 4096;
+
+        inline size_t round_up(size_t value, size_t unit) {
+            return (value + unit - 1) / unit * unit;
+        }
+
+        struct aligned_free {
+            void operator()(char* p) const noexcept { std::free(p); }
+        };
+        using aligned_bytes = std::unique_ptr<char, aligned_free>;
+
+        inline aligned_bytes allocate_aligned(size_t bytes) {
+            void* p = nullptr;
+            if (::posix_memalign(&p, io_alignment, bytes ? bytes : io_alignment) != 0) throw std::bad_alloc();
+            return aligned_bytes(static_cast<char*>(p));
+        }
+
+        /**
+         * @brief Positional file I/O with optional O_DIRECT
+         */
+        class sort_file {
+        private:
+            int _fd;
+            bool _direct;
+
+            [[noreturn]] static void fail(const std::string& what) {
+                throw std::system_error(errno, std::generic_category(), "external_sort: " + what);
+            }
+
+        public:
+            sort_file(const std::string& path, int flags, bool direct) : _fd(-1), _direct(false) {
+#if defined(O_DIRECT)
+                if (direct) {
+                    _fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+                    if (_fd >= 0) {
+                        _direct = true;
+                        return;
+                    }
+                }
+#else
+                (void)direct;
+#endif
+                _fd = ::open(path.c_str(), flags, 0644);
+                if (_fd < 0) fail("open " + path);
+            }
+
+            ~sort_file() {
+                if (_fd >= 0) ::close(_fd);
+            }
+
+            sort_file(const sort_file&) = delete;
+            sort_file& operator=(const sort_file&) = delete;
+
+            bool direct() const noexcept { return _direct; }
+
+            uint64_t size() const {
+                struct stat st;
+                if (::fstat(_fd, &st) != 0) fail("fstat");
+                return static_cast<uint64_t>(st.st_size);
+            }
+
+            /**
+             * @brief Reads up to len bytes at off, returns bytes read (short only at EOF)
+             */
+            size_t read_at(void* buf, size_t len, uint64_t off) const {
+                char* p = static_cast<char*>(buf);
+                size_t done = 0;
+                while (done < len) {
+                    ssize_t r = ::pread(_fd, p + done, len - done, static_cast<off_t>(off + done));
+                    if (r < 0) {
+                        if (errno == EINTR) continue;
+                        fail("pread");
+                    }
+                    if (r == 0) break;
+                    done += static_cast<size_t>(r);
+                }
+                return done;
+            }
+
+            void write_at(const void* buf, size_t len, uint64_t off) const {
+                const char* p = static_cast<const char*>(buf);
+                size_t done = 0;
+                while (done < len) {
+                    ssize_t w = ::pwrite(_fd, p + done, len - done, static_cast<off_t>(off + done));
+                    if (w < 0) {
+                        if (errno == EINTR) continue;
+                        fail("pwrite");
+                    }
+                    done += static_cast<size_t>(w);
+                }
+            }
+
+            void advise_sequential() const noexcept {
+#if defined(POSIX_FADV_SEQUENTIAL)
+                ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            }
+        };
+
+        /**
+         * @brief LSD radix sort on 8-bit digits, skipping digits all keys share
+         */
+        template <typename T>
+        void radix_sort(T* data, T* scratch, size_t n) {
+            static_assert(std::is_unsigned_v<T>, "radix_sort requires unsigned keys");
+            T* src = data;
+            T* dst = scratch;
+            for (unsigned shift = 0; shift < sizeof(T) * 8; shift += 8) {
+                size_t count[256] = {};
+                for (size_t i = 0; i < n; ++i) {
+                    ++count[(src[i] >> shift) & 0xff];
+                }
+                if (std::find(std::begin(count), std::end(count), n) != std::end(count)) continue;
+
+                size_t offset = 0;
+                for (size_t& c : count) {
+                    size_t next = offset + c;
+                    c = offset;
+                    offset = next;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    dst[count[(src[i] >> shift) & 0xff]++] = src[i];
+                }
+                std::swap(src, dst);
+            }
+            if (src != data) std::memcpy(data, src, n * sizeof(T));
+        }
+
+        /**
+         * @brief Sorted run on disk; elements are contiguous from offset 0, tail block padded
+         */
+        struct sorted_run {
+            std::string path;
+            size_t count;
+        };
+
+        /**
+         * @brief Streams a run with one block consumed while the next is read ahead
+         */
+        template <typename T>
+        class run_reader {
+        private:
+            std::unique_ptr<sort_file> _file;
+            size_t _block_bytes;
+            aligned_bytes _blocks[2];
+            std::future<size_t> _ahead;
+            const T* _cur;
+            size_t _cur_n;
+            size_t _pos;
+            size_t _remaining;    // Elements not yet delivered from the current or later blocks
+            uint64_t _next_off;
+            uint64_t _file_bytes;
+            int _active;
+
+            void read_ahead() {
+                if (_next_off >= _file_bytes) return;
+                char* buf = _blocks[_active ^ 1].get();
+                const sort_file* file = _file.get();
+                const size_t len = _block_bytes;
+                const uint64_t off = _next_off;
+                _ahead = std::async(std::launch::async, [file, buf, len, off] { return file->read_at(buf, len, off); });
+                _next_off += _block_bytes;
+            }
+
+            void next_block() {
+                if (!_ahead.valid()) {
+                    _cur_n = 0;
+                    return;
+                }
+                size_t bytes = _ahead.get();
+                _active ^= 1;
+                _cur = reinterpret_cast<const T*>(_blocks[_active].get());
+                _cur_n = std::min(bytes / sizeof(T), _remaining);
+                _pos = 0;
+                read_ahead();
+            }
+
+        public:
+            run_reader(const sorted_run& run, size_t block_bytes, bool direct)
+                : _file(new sort_file(run.path, O_RDONLY, direct)), _block_bytes(block_bytes),
+                  _cur(nullptr), _cur_n(0), _pos(0), _remaining(run.count), _next_off(0), _active(1)
+            {
+                _file_bytes = _file->size();
+                _blocks[0] = allocate_aligned(block_bytes);
+                _blocks[1] = allocate_aligned(block_bytes);
+                if (!_file->direct()) _file->advise_sequential();
+                read_ahead();
+                next_block();
+            }
+
+            ~run_reader() {
+                if (_ahead.valid()) _ahead.wait();
+            }
+
+            bool exhausted() const noexcept { return _remaining == 0; }
+            const T& head() const noexcept { return _cur[_pos]; }
+
+            void advance() {
+                --_remaining;
+                if (++_pos == _cur_n && _remaining > 0) next_block();
+            }
+        };
+
+        /**
+         * @brief Double-buffered block writer; one block fills while the other is written
+         */
+        template <typename T>
+        class run_writer {
+        private:
+            std::unique_ptr<sort_file> _file;
+            size_t _block_bytes;
+            aligned_bytes _blocks[2];
+            std::future<void> _pending;
+            size_t _fill;
+            uint64_t _off;
+            size_t _count;
+            int _active;
+
+            void flush_block() {
+                if (_pending.valid()) _pending.get();
+                size_t len = _file->direct() ? round_up(_fill, io_alignment) : _fill;
+                const sort_file* file = _file.get();
+                const char* buf = _blocks[_active].get();
+                const uint64_t off = _off;
+                _pending = std::async(std::launch::async, [file, buf, len, off] { file->write_at(buf, len, off); });
+                _off += _fill;
+                _fill = 0;
+                _active ^= 1;
+            }
+
+        public:
+            run_writer(const std::string& path, size_t block_bytes, bool direct)
+                : _file(new sort_file(path, O_WRONLY | O_CREAT | O_TRUNC, direct)), _block_bytes(block_bytes),
+                  _fill(0), _off(0), _count(0), _active(0)
+            {
+                _blocks[0] = allocate_aligned(block_bytes);
+                _blocks[1] = allocate_aligned(block_bytes);
+            }
+
+            ~run_writer() {
+                if (_pending.valid()) _pending.wait();
+            }
+
+            bool direct() const noexcept { return _file->direct(); }
+
+            void push(const T& value) {
+                std::memcpy(_blocks[_active].get() + _fill, &value, sizeof(T));
+                _fill += sizeof(T);
+                ++_count;
+                if (_fill == _block_bytes) flush_block();
+            }
+
+            size_t finish() {
+                if (_fill > 0) flush_block();
+                if (_pending.valid()) _pending.get();
+                return _count;
+            }
+        };
+
+        /**
+         * @brief Tournament tree of losers over k sources
+         * tree[0] holds the overall winner, tree[1..k) the loser of each match;
+         * replacing the winner's head replays only its leaf-to-root path
+         */
+        template <typename Less>
+        class loser_tree {
+        private:
+            std::vector<size_t> _tree;
+            size_t _k;
+            Less _less;
+
+            size_t build(size_t node) {
+                if (node >= _k) return node - _k;
+                size_t left = build(2 * node);
+                size_t right = build(2 * node + 1);
+                if (_less(right, left)) std::swap(left, right);
+                _tree[node] = right;
+                return left;
+            }
+
+        public:
+            loser_tree(size_t k, Less less) : _tree(std::max<size_t>(k, 1)), _k(k), _less(less) {
+                _tree[0] = build(1);
+            }
+
+            size_t winner() const noexcept { return _tree[0]; }
+
+            void replay() {
+                size_t w = _tree[0];
+                for (size_t node = (w + _k) / 2; node >= 1; node /= 2) {
+                    if (_less(_tree[node], w)) std::swap(_tree[node], w);
+                }
+                _tree[0] = w;
+            }
+        };
+
+        /**
+         * @brief Block size for n inputs plus the double-buffered output within budget
+         * Multiple of both 4 KB (O_DIRECT) and sizeof(T) (whole records per block)
+         */
+        template <typename T>
+        size_t merge_block_bytes(size_t budget, size_t inputs) {
+            const size_t unit = std::lcm(io_alignment, sizeof(T));
+            size_t block = budget / (2 * inputs + 2);
+            block = block / unit * unit;
+            return std::max(block, unit);
+        }
+
+        template <typename T, typename Compare>
+        void merge_runs(const std::vector<sorted_run>& runs, size_t first, size_t last, run_writer<T>& out,
+                        size_t block_bytes, bool direct, Compare comp) {
+            std::vector<std::unique_ptr<run_reader<T>>> readers;
+            readers.reserve(last - first);
+            for (size_t i = first; i < last; ++i) {
+                readers.emplace_back(new run_reader<T>(runs[i], block_bytes, direct));
+            }
+
+            auto less = [&readers, comp](size_t a, size_t b) {
+                if (readers[a]->exhausted()) return false;
+                if (readers[b]->exhausted()) return true;
+                return comp(readers[a]->head(), readers[b]->head());
+            };
+            loser_tree<decltype(less)> tree(readers.size(), less);
+
+            for (;;) {
+                run_reader<T>& r = *readers[tree.winner()];
+                if (r.exhausted()) break;
+                out.push(r.head());
+                r.advance();
+                tree.replay();
+            }
+        }
+    }
+
+    /**
+     * @brief Sorts the records of input_path into output_path using at most options.memory_budget bytes
+     * @tparam T Trivially copyable record type; the files hold raw T records back to back
+     */
+    template <typename T, typename Compare = std::less<T>>
+    external_sort_stats external_sort(const std::string& input_path, const std::string& output_path,
+                                      const external_sort_options& options = external_sort_options(),
+                                      Compare comp = Compare()) {
+        static_assert(std::is_trivially_copyable_v<T>, "external_sort records must be trivially copyable");
+        constexpr bool radix_capable = std::is_unsigned_v<T> &&
+            (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>);
+        const bool radix = radix_capable && options.use_radix;
+
+        external_sort_stats stats;
+        detail::sort_file input(input_path, O_RDONLY, false);
+        input.advise_sequential();
+        if (input.size() % sizeof(T) != 0) {
+            throw std::runtime_error("external_sort: input size is not a multiple of the record size");
+        }
+        const size_t total = static_cast<size_t>(input.size() / sizeof(T));
+        stats.records = total;
+
+        const std::string temp_dir = options.temp_dir.empty()
+            ? std::filesystem::temp_directory_path().string() : options.temp_dir;
+        static std::atomic<uint64_t> run_counter{0};
+        auto temp_run_path = [&temp_dir] {
+            return (std::filesystem::path(temp_dir) /
+                    ("benchy_xsort_" + std::to_string(::getpid()) + "_" +
+                     std::to_string(run_counter.fetch_add(1)) + ".run")).string();
+        };
+
+        // Run formation: two chunk buffers (plus a radix scratch buffer) within the budget
+        const size_t buffers = radix ? 3 : 2;
+        const size_t chunk_elems = std::max<size_t>(options.memory_budget / (buffers * sizeof(T)), 1);
+        const size_t chunk_bytes = detail::round_up(chunk_elems * sizeof(T), detail::io_alignment);
+
+        std::vector<detail::sorted_run> runs;
+        std::vector<std::string> outputs;  // Merge outputs (and output_path), removed on failure
+        auto cleanup = [](const std::vector<detail::sorted_run>& done, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) std::remove(done[i].path.c_str());
+        };
+
+        try {
+            detail::aligned_bytes chunk[2] = { detail::allocate_aligned(chunk_bytes), detail::allocate_aligned(chunk_bytes) };
+            detail::aligned_bytes scratch;
+            if (radix) scratch = detail::allocate_aligned(chunk_bytes);
+            std::future<void> pending;
+
+            auto sort_chunk = [&](T* data, size_t n) {
+                if constexpr (radix_capable) {
+                    if (radix) {
+                        detail::radix_sort(data, reinterpret_cast<T*>(scratch.get()), n);
+                        return;
+                    }
+                }
+                std::sort(data, data + n, comp);
+            };
+
+            if (total <= chunk_elems) {
+                // Fits in one chunk: sort in memory and write the output directly
+                T* data = reinterpret_cast<T*>(chunk[0].get());
+                input.read_at(data, total * sizeof(T), 0);
+                sort_chunk(data, total);
+                outputs.push_back(output_path);
+                detail::sort_file out(output_path, O_WRONLY | O_CREAT | O_TRUNC, false);
+                out.write_at(data, total * sizeof(T), 0);
+                stats.runs = total ? 1 : 0;
+                return stats;
+            }
+
+            for (size_t offset = 0, r = 0; offset < total; ++r) {
+                const size_t n = std::min(chunk_elems, total - offset);
+                char* buf = chunk[r & 1].get();
+                input.read_at(buf, n * sizeof(T), offset * sizeof(T));
+                sort_chunk(reinterpret_cast<T*>(buf), n);
+
+                if (pending.valid()) pending.get();
+                runs.push_back(detail::sorted_run{temp_run_path(), n});
+                const std::string path = runs.back().path;
+                const bool direct = options.direct_io;
+                pending = std::async(std::launch::async, [path, buf, n, direct, &stats] {
+                    detail::sort_file run(path, O_WRONLY | O_CREAT | O_TRUNC, direct);
+                    if (run.direct()) stats.direct_io = true;
+                    size_t bytes = n * sizeof(T);
+                    run.write_at(buf, run.direct() ? detail::round_up(bytes, detail::io_alignment) : bytes, 0);
+                });
+                offset += n;
+            }
+            pending.get();
+            stats.runs = runs.size();
+
+            // Intermediate passes while the budget cannot hold two blocks per run
+            const size_t min_block = detail::round_up(size_t(256) << 10, std::lcm(detail::io_alignment, sizeof(T)));
+            const size_t fan_in = std::max<size_t>(options.memory_budget / (2 * min_block), 3) - 1;
+            while (runs.size() > fan_in) {
+                std::vector<detail::sorted_run> merged;
+                for (size_t first = 0; first < runs.size(); first += fan_in) {
+                    const size_t last = std::min(first + fan_in, runs.size());
+                    const size_t block = detail::merge_block_bytes<T>(options.memory_budget, last - first);
+                    detail::sorted_run out_run{temp_run_path(), 0};
+                    outputs.push_back(out_run.path);
+                    {
+                        detail::run_writer<T> writer(out_run.path, block, options.direct_io);
+                        detail::merge_runs(runs, first, last, writer, block, options.direct_io, comp);
+                        out_run.count = writer.finish();
+                    }
+                    cleanup(runs, first, last);
+                    merged.push_back(out_run);
+                }
+                runs.swap(merged);
+                ++stats.merge_passes;
+            }
+
+            const size_t block = detail::merge_block_bytes<T>(options.memory_budget, runs.size());
+            outputs.push_back(output_path);
+            detail::run_writer<T> writer(output_path, block, false);
+            detail::merge_runs(runs, 0, runs.size(), writer, block, options.direct_io, comp);
+            writer.finish();
+            ++stats.merge_passes;
+        }
+        catch (...) {
+            cleanup(runs, 0, runs.size());
+            for (const std::string& path : outputs) std::remove(path.c_str());
+            throw;
+        }
+        cleanup(runs, 0, runs.size());
+        return stats;
+    }
+}
+#endif
@@ -0,0 +1,319 @@
+#pragma once
+#if defined(__unix__) || defined(__APPLE__)
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief A growable vector whose storage is a memory-mapped file (persistent append-only log)
+ *
+ * File layout:
+ * - 4 KB header page: magic, format version, element size, published length
+ * - Element array starting at offset 4096 (page aligned), capacity = file size - 4096
+ *
+ * Algorithm:
+ * - Elements are written straight into a MAP_SHARED mapping, so the page cache
+ *   is the buffer: there is no separate copy and no write() call to persist them
+ * - Growth doubles capacity with ftruncate + mremap (munmap/mmap off Linux)
+ * - The length in the header is the commit point. It is only advanced by
+ *   publish()/checkpoint(), after the element bytes it covers were written
+ *   (and, for checkpoint, made durable), so a reopened file never exposes
+ *   a torn tail; truncate() lowers it and syncs the header before later appends
+ *   can overwrite the dropped elements
+ * - Reopening maps the file and reads the header; no element is read or copied
+ *
+ * Performance characteristics vs shared::vector + fwrite:
+ * - One write of each record (into the mapping) instead of two (into the vector, then fwrite)
+ * - Growth never copies elements, mremap moves page table entries only
+ * - First touch of each new page takes a page fault, which fwrite avoids
+ *
+ * Limitations:
+ * - T must be trivially copyable; elements are raw bytes in the file
+ * - POSIX only; not thread-safe for concurrent writers
+ * - OS failures are reported by throwing std::system_error
+ */
+
+namespace shared {
+    template <typename T>
+    class file_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "file_vector elements must be trivially copyable");
+
+    public:
+        /**
+         * @brief How checkpoint() persists data before publishing the length
+         * - async: msync(MS_ASYNC), schedules writeback only (survives process crash)
+         * - range: sync_file_range over the dirty element range on Linux, writes pages
+         *          without flushing file metadata or the device cache; msync(MS_SYNC) elsewhere
+         * - full:  msync(MS_SYNC) + fdatasync, survives power loss
+         */
+        enum class sync_mode { async, range, full };
+
+    private:
+        struct header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t elem_size;
+            uint64_t length;  // Published element count, the crash-consistent commit point
+        };
+
+        static constexpr uint64_t file_magic = 0x5254435646594842ull;  // "BHYFVCTR"
+        static constexpr uint32_t file_version = 1;
+        static constexpr size_t header_bytes = 4096;
+
+        int _fd;
+        char* _base;        // Start of the mapping (header page)
+        size_t _size;       // Elements written
+        size_t _space;      // Elements the file currently holds
+        size_t _synced;     // Elements covered by the last checkpoint
+
+        size_t mapped_bytes() const noexcept { return header_bytes + _space * sizeof(T); }
+        header* hdr() const noexcept { return reinterpret_cast<header*>(_base); }
+        T* elements() const noexcept { return reinterpret_cast<T*>(_base + header_bytes); }
+
+        [[noreturn]] static void fail(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        void map(size_t bytes) {
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+            if (p == MAP_FAILED) fail("file_vector: mmap");
+            _base = static_cast<char*>(p);
+        }
+
+        void remap(size_t new_space) {
+            const size_t old_bytes = mapped_bytes();
+            const size_t new_bytes = header_bytes + new_space * sizeof(T);
+            if (::ftruncate(_fd, static_cast<off_t>(new_bytes)) != 0) fail("file_vector: ftruncate");
+#if defined(__linux__)
+            void* p = ::mremap(_base, old_bytes, new_bytes, MREMAP_MAYMOVE);
+            if (p == MAP_FAILED) fail("file_vector: mremap");
+            _base = static_cast<char*>(p);
+#else
+            ::munmap(_base, old_bytes);
+            map(new_bytes);
+#endif
+            _space = new_space;
+        }
+
+        void sync_elements(size_t from, size_t to, sync_mode mode) {
+            if (to <= from) return;
+            // msync needs a page-aligned start; the header page offset keeps elements page aligned
+            const long page = ::sysconf(_SC_PAGESIZE);
+            size_t begin = header_bytes + from * sizeof(T);
+            size_t end = header_bytes + to * sizeof(T);
+            begin -= begin % static_cast<size_t>(page);
+
+            switch (mode) {
+                case sync_mode::async:
+                    if (::msync(_base + begin, end - begin, MS_ASYNC) != 0) fail("file_vector: msync");
+                    break;
+                case sync_mode::range:
+#if defined(__linux__)
+                    if (::sync_file_range(_fd, static_cast<off_t>(begin), static_cast<off_t>(end - begin),
+                            SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER) != 0) {
+                        fail("file_vector: sync_file_range");
+                    }
+                    break;
+#endif
+                case sync_mode::full:
+                    if (::msync(_base + begin, end - begin, MS_SYNC) != 0) fail("file_vector: msync");
+                    break;
+            }
+        }
+
+        void release() noexcept {
+            if (_base) {
+                publish();
+                ::munmap(_base, mapped_bytes());
+                _base = nullptr;
+            }
+            if (_fd >= 0) {
+                ::close(_fd);
+                _fd = -1;
+            }
+            _size = _space = _synced = 0;
+        }
+
+    public:
+        /**
+         * @brief Opens path, creating it if missing
+         * An existing file is mapped as-is and exposes its last published length
+         * @param initial_capacity Capacity of a newly created file, in elements
+         */
+        explicit file_vector(const std::string& path, size_t initial_capacity = 1024)
+            : _fd(-1), _base(nullptr), _size(0), _space(0), _synced(0)
+        {
+            _fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (_fd < 0) fail("file_vector: open");
+
+            try {
+                struct stat st;
+                if (::fstat(_fd, &st) != 0) fail("file_vector: fstat");
+
+                if (st.st_size == 0) {
+                    _space = initial_capacity ? initial_capacity : 1;
+                    if (::ftruncate(_fd, static_cast<off_t>(mapped_bytes())) != 0) fail("file_vector: ftruncate");
+                    map(mapped_bytes());
+                    header* h = hdr();
+                    h->magic = file_magic;
+                    h->version = file_version;
+                    h->elem_size = sizeof(T);
+                    h->length = 0;
+                }
+                else {
+                    if (static_cast<size_t>(st.st_size) < header_bytes) {
+                        throw std::runtime_error("file_vector: file too small for header");
+                    }
+                    _space = (static_cast<size_t>(st.st_size) - header_bytes) / sizeof(T);
+                    map(header_bytes + _space * sizeof(T));
+                    const header* h = hdr();
+                    if (h->magic != file_magic || h->version != file_version || h->elem_size != sizeof(T)) {
+                        throw std::runtime_error("file_vector: header mismatch");
+                    }
+                    _size = _synced = static_cast<size_t>(h->length);
+                    if (_size > _space) {
+                        throw std::runtime_error("file_vector: published length exceeds file size");
+                    }
+                }
+            }
+            catch (...) {
+                if (_base) ::munmap(_base, mapped_bytes());
+                ::close(_fd);
+                throw;
+            }
+        }
+
+        /**
+         * @brief Publishes the current length and unmaps; does not force writeback
+         */
+        ~file_vector() {
+            release();
+        }
+
+        file_vector(file_vector&& other) noexcept
+            : _fd(other._fd), _base(other._base), _size(other._size), _space(other._space), _synced(other._synced)
+        {
+            other._fd = -1;
+            other._base = nullptr;
+            other._size = other._space = other._synced = 0;
+        }
+
+        file_vector& operator=(file_vector&& other) noexcept {
+            if (this != &other) {
+                release();
+                _fd = other._fd;
+                _base = other._base;
+                _size = other._size;
+                _space = other._space;
+                _synced = other._synced;
+                other._fd = -1;
+                other._base = nullptr;
+                other._size = other._space = other._synced = 0;
+            }
+            return *this;
+        }
+
+        file_vector(const file_vector&) = delete;
+        file_vector& operator=(const file_vector&) = delete;
+
+        /**
+         * @brief Grows the backing file to hold at least new_alloc elements
+         */
+        void reserve(size_t new_alloc) {
+            if (new_alloc > _space) remap(new_alloc);
+        }
+
+        /**
+         * @brief Appends one element, doubling the file when full
+         */
+        void push_back(const T& val) {
+            if (_size == _space) remap(std::max<size_t>(1, 2 * _space));   // A header-only file reopens with no space
+            elements()[_size++] = val;
+        }
+
+        /**
+         * @brief Appends n elements with a single bounds check and memcpy
+         */
+        void append(const T* vals, size_t n) {
+            if (_size + n > _space) {
+                size_t new_space = std::max<size_t>(1, 2 * _space);
+                while (new_space < _size + n) new_space *= 2;
+                remap(new_space);
+            }
+            std::memcpy(elements() + _size, vals, n * sizeof(T));
+            _size += n;
+        }
+
+        /**
+         * @brief Drops elements past new_size (file capacity is kept)
+         * A published length past new_size is lowered and the header synced before
+         * returning, so a reopened file never exposes the dropped elements
+         */
+        void truncate(size_t new_size) {
+            if (new_size < _size) {
+                _size = new_size;
+                if (_synced > _size) _synced = _size;
+            }
+            if (new_size < hdr()->length) {
+                hdr()->length = new_size;
+                if (::msync(_base, header_bytes, MS_SYNC) != 0) fail("file_vector: msync");
+            }
+        }
+
+        /**
+         * @brief Makes the current length visible to reopeners without forcing writeback
+         * Safe against process crashes: MAP_SHARED pages live in the page cache
+         */
+        void publish() noexcept {
+            std::atomic_thread_fence(std::memory_order_release);
+            hdr()->length = _size;
+        }
+
+        /**
+         * @brief Persists elements appended since the last checkpoint, then publishes the length
+         * Data is synced before the header, so a crash mid-checkpoint leaves the previous length
+         */
+        void checkpoint(sync_mode mode = sync_mode::full) {
+            sync_elements(_synced, _size, mode);
+            publish();
+            if (::msync(_base, header_bytes, mode == sync_mode::async ? MS_ASYNC : MS_SYNC) != 0) {
+                fail("file_vector: msync");
+            }
+#if defined(__linux__)
+            if (mode == sync_mode::full && ::fdatasync(_fd) != 0) fail("file_vector: fdatasync");
+#else
+            if (mode == sync_mode::full && ::fsync(_fd) != 0) fail("file_vector: fsync");
+#endif
+            _synced = _size;
+        }
+
+        // Element access
+        T& operator[](size_t i) { return elements()[i]; }
+        const T& operator[](size_t i) const { return elements()[i]; }
+        T* data() { return elements(); }
+        const T* data() const { return elements(); }
+        T* begin() { return elements(); }
+        T* end() { return elements() + _size; }
+        const T* begin() const { return elements(); }
+        const T* end() const { return elements() + _size; }
+        T& back() { return elements()[_size - 1]; }
+        const T& back() const { return elements()[_size - 1]; }
+
+        bool empty() const { return _size == 0; }
+        size_t size() const { return _size; }
+        size_t capacity() const { return _space; }
+        size_t durable_size() const { return _synced; }
+    };
+}
+#endif
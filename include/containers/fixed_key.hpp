@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "hash.hpp"
+#include "map.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Fixed-width inline keys (UUIDs, short strings) for shared::map
+ *
+ * Layout:
+ * - fixed_key<N> holds N raw bytes (N a multiple of 16), 16-byte aligned, inside the
+ *   table slot itself; no heap pointer to follow on compare
+ * - short_string_key is a fixed_key<16> with up to 15 characters zero-padded and the
+ *   length in the last byte, so equal strings have identical bytes
+ *
+ * Performance characteristics vs std::string keys:
+ * - Equality is one SSE2 pcmpeqb + pmovmskb per 16 bytes instead of a size check and
+ *   memcmp through two (possibly heap) pointers
+ * - The hash folds 64-bit words with the wyhash multiply-mix instead of a byte loop
+ * - A short_string_key is 16 bytes against 32 for std::string on libstdc++, and never allocates
+ *
+ * Limitations:
+ * - short_string_key throws std::length_error for strings longer than 15 bytes
+ */
+
+namespace shared {
+    template <size_t N>
+    struct alignas(16) fixed_key {
+        static_assert(N > 0 && N % 16 == 0, "fixed_key width must be a multiple of 16 bytes");
+        static constexpr size_t size = N;
+
+        unsigned char bytes[N];
+
+        fixed_key() noexcept : bytes() {}
+
+        explicit fixed_key(const void* data) noexcept {
+            std::memcpy(bytes, data, N);
+        }
+
+        friend bool operator==(const fixed_key& a, const fixed_key& b) noexcept {
+#if defined(__SSE2__) || defined(_M_X64)
+            for (size_t i = 0; i < N; i += 16) {
+                const __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(a.bytes + i));
+                const __m128i y = _mm_load_si128(reinterpret_cast<const __m128i*>(b.bytes + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) return false;
+            }
+            return true;
+#else
+            return std::memcmp(a.bytes, b.bytes, N) == 0;
+#endif
+        }
+
+        friend bool operator!=(const fixed_key& a, const fixed_key& b) noexcept {
+            return !(a == b);
+        }
+    };
+
+    /**
+     * @brief Inline string of at most 15 bytes; byte 15 stores the length
+     */
+    struct short_string_key : fixed_key<16> {
+        static constexpr size_t max_length = 15;
+
+        short_string_key() noexcept = default;
+
+        short_string_key(std::string_view s) {
+            if (s.size() > max_length) {
+                throw std::length_error("short_string_key: string longer than 15 bytes");
+            }
+            std::memcpy(bytes, s.data(), s.size());
+            bytes[max_length] = static_cast<unsigned char>(s.size());
+        }
+
+        short_string_key(const std::string& s) : short_string_key(std::string_view(s)) {}
+
+        short_string_key(const char* s) : short_string_key(std::string_view(s)) {}
+
+        size_t length() const noexcept { return bytes[max_length]; }
+
+        std::string_view view() const noexcept {
+            return std::string_view(reinterpret_cast<const char*>(bytes), length());
+        }
+    };
+
+    /**
+     * @brief Word-at-a-time hash for fixed_key, wyhash multiply-mix per 16 bytes
+     */
+    template <size_t N>
+    struct hasher<fixed_key<N>> {
+        size_t operator()(const fixed_key<N>& key) const noexcept {
+            uint64_t seed = hashes::detail::wy_secret[0];
+            for (size_t i = 0; i < N; i += 16) {
+                seed = hashes::detail::mix(hashes::detail::read64(key.bytes + i) ^ hashes::detail::wy_secret[1],
+                                           hashes::detail::read64(key.bytes + i + 8) ^ seed);
+            }
+            return static_cast<size_t>(hashes::detail::mix(seed ^ hashes::detail::wy_secret[2], N ^ hashes::detail::wy_secret[3]));
+        }
+    };
+
+    template <>
+    struct hasher<short_string_key> : hasher<fixed_key<16>> {};
+
+    /**
+     * @brief Map keyed by 16-byte ids (UUIDs) stored inline in the slots
+     */
+    template <typename v, size_t InitialSize = 8>
+    using uuid_map = map<fixed_key<16>, v, InitialSize>;
+
+    /**
+     * @brief Map keyed by strings of at most 15 bytes stored inline in the slots
+     */
+    template <typename v, size_t InitialSize = 8>
+    using short_string_map = map<short_string_key, v, InitialSize>;
+}
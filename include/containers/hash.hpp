@@ -0,0 +1,292 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <type_traits>
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Bundled fast hash functions usable as drop-in hashers for shared::map
+ *
+ * Algorithms:
+ * - FNV-1a (64-bit): byte-at-a-time xor/multiply, the reference for hash_fn's claims
+ * - MurmurHash64A: 8 bytes per round, murmur3 fmix64 finalizer for integer keys
+ * - wyhash (final4 layout): 16/48 bytes per round using 64x64->128 multiply-fold
+ *
+ * Performance characteristics vs shared::hash_fn:
+ * - hash_fn processes one byte per step with a shift/add chain (djb2), no finalizer
+ * - Murmur and wyhash process a word per step and fully mix high bits into low bits,
+ *   which matters because shared::map masks the hash with (capacity - 1)
+ *
+ * Limitations:
+ * - Generic hashers hash the object representation, so types with padding or
+ *   owning pointers need an explicit specialization (std::string is handled)
+ * - Not cryptographic; seeding only raises the bar against casual flooding
+ *
+ * Flooding:
+ * - hash_fn and the unseeded hashers are public functions of the key, so colliding keys
+ *   can be computed offline and every insert walks one probe chain (O(n^2) total)
+ * - seeded_hasher keys wyhash with a per-instance seed; each map built with it gets its
+ *   own seed, so a key set colliding in one map (or for hash_fn) spreads out in another
+ */
+
+namespace shared {
+    namespace hashes {
+        namespace detail {
+            inline uint64_t read64(const unsigned char* p) noexcept {
+                uint64_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            inline uint64_t read32(const unsigned char* p) noexcept {
+                uint32_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            /**
+             * @brief 64x64 -> 128 bit multiply, returns low half in a and high half in b
+             */
+            inline void mum(uint64_t& a, uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+                __extension__ typedef unsigned __int128 u128;
+                u128 r = static_cast<u128>(a) * b;
+                a = static_cast<uint64_t>(r);
+                b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+                a = _umul128(a, b, &b);
+#else
+                uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+                uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+                uint64_t t = rl + (rm0 << 32), c = t < rl;
+                uint64_t lo = t + (rm1 << 32);
+                c += lo < t;
+                a = lo;
+                b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+            }
+
+            inline uint64_t mix(uint64_t a, uint64_t b) noexcept {
+                mum(a, b);
+                return a ^ b;
+            }
+
+            constexpr uint64_t wy_secret[4] = {
+                0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+            };
+        }
+
+        /**
+         * @brief 64-bit FNV-1a over a byte range
+         */
+        inline uint64_t fnv1a(const void* data, size_t len) noexcept {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < len; ++i) {
+                hash ^= p[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        /**
+         * @brief MurmurHash3 64-bit finalizer, a full-avalanche mix for a single word
+         */
+        inline uint64_t fmix64(uint64_t k) noexcept {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdull;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ull;
+            k ^= k >> 33;
+            return k;
+        }
+
+        /**
+         * @brief MurmurHash64A (Austin Appleby) over a byte range
+         */
+        inline uint64_t murmur64a(const void* data, size_t len, uint64_t seed = 0) noexcept {
+            constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+            constexpr int r = 47;
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            uint64_t h = seed ^ (len * m);
+
+            const size_t blocks = len / 8;
+            for (size_t i = 0; i < blocks; ++i) {
+                uint64_t k = detail::read64(p + i * 8);
+                k *= m;
+                k ^= k >> r;
+                k *= m;
+                h ^= k;
+                h *= m;
+            }
+
+            const unsigned char* tail = p + blocks * 8;
+            const size_t rem = len & 7;
+            if (rem) {
+                for (size_t i = rem; i-- > 0; ) {
+                    h ^= static_cast<uint64_t>(tail[i]) << (8 * i);
+                }
+                h *= m;
+            }
+
+            h ^= h >> r;
+            h *= m;
+            h ^= h >> r;
+            return h;
+        }
+
+        /**
+         * @brief wyhash (final4 variant) over a byte range
+         */
+        inline uint64_t wyhash(const void* data, size_t len, uint64_t seed = 0) noexcept {
+            using detail::read32;
+            using detail::read64;
+            using detail::wy_secret;
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            seed ^= detail::mix(seed ^ wy_secret[0], wy_secret[1]);
+
+            uint64_t a, b;
+            if (len <= 16) {
+                if (len >= 4) {
+                    a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+                    b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+                }
+                else if (len > 0) {
+                    a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+                    b = 0;
+                }
+                else {
+                    a = b = 0;
+                }
+            }
+            else {
+                size_t i = len;
+                if (i > 48) {
+                    uint64_t see1 = seed, see2 = seed;
+                    do {
+                        seed = detail::mix(read64(p) ^ wy_secret[1], read64(p + 8) ^ seed);
+                        see1 = detail::mix(read64(p + 16) ^ wy_secret[2], read64(p + 24) ^ see1);
+                        see2 = detail::mix(read64(p + 32) ^ wy_secret[3], read64(p + 40) ^ see2);
+                        p += 48;
+                        i -= 48;
+                    } while (i > 48);
+                    seed ^= see1 ^ see2;
+                }
+                while (i > 16) {
+                    seed = detail::mix(read64(p) ^ wy_secret[1], read64(p + 8) ^ seed);
+                    i -= 16;
+                    p += 16;
+                }
+                a = read64(p + i - 16);
+                b = read64(p + i - 8);
+            }
+
+            a ^= wy_secret[1];
+            b ^= seed;
+            detail::mum(a, b);
+            return detail::mix(a ^ wy_secret[0] ^ len, b ^ wy_secret[1]);
+        }
+
+        /**
+         * @brief wyhash single-word path for integer keys
+         */
+        inline uint64_t wyhash64(uint64_t key, uint64_t seed = 0) noexcept {
+            uint64_t a = key ^ 0x2d358dccaa6c78a5ull, b = seed ^ 0x8bb84b93962eacc9ull;
+            detail::mum(a, b);
+            return detail::mix(a ^ 0x2d358dccaa6c78a5ull, b ^ 0x8bb84b93962eacc9ull);
+        }
+    }
+
+    /**
+     * @brief Hasher adapters with the same object-bytes contract as hash_fn
+     * Integer and pointer keys take a single-word fast path; std::string hashes its contents
+     */
+    template <typename T>
+    struct fnv1a_hasher {
+        size_t operator()(const T& value) const noexcept {
+            if constexpr (std::is_same_v<T, std::string>) {
+                return static_cast<size_t>(hashes::fnv1a(value.data(), value.size()));
+            } else {
+                return static_cast<size_t>(hashes::fnv1a(&value, sizeof(T)));
+            }
+        }
+    };
+
+    template <typename T>
+    struct murmur_hasher {
+        size_t operator()(const T& value) const noexcept {
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                return static_cast<size_t>(hashes::fmix64(static_cast<uint64_t>(value)));
+            } else if constexpr (std::is_pointer_v<T>) {
+                return static_cast<size_t>(hashes::fmix64(reinterpret_cast<uintptr_t>(value)));
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                return static_cast<size_t>(hashes::murmur64a(value.data(), value.size()));
+            } else {
+                return static_cast<size_t>(hashes::murmur64a(&value, sizeof(T)));
+            }
+        }
+    };
+
+    template <typename T>
+    struct wy_hasher {
+        size_t operator()(const T& value) const noexcept {
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                return static_cast<size_t>(hashes::wyhash64(static_cast<uint64_t>(value)));
+            } else if constexpr (std::is_pointer_v<T>) {
+                return static_cast<size_t>(hashes::wyhash64(reinterpret_cast<uintptr_t>(value)));
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                return static_cast<size_t>(hashes::wyhash(value.data(), value.size()));
+            } else {
+                return static_cast<size_t>(hashes::wyhash(&value, sizeof(T)));
+            }
+        }
+    };
+
+    namespace hashes {
+        /**
+         * @brief Returns a fresh 64-bit seed per call
+         * A process-wide random_device draw, mixed with a per-call counter through fmix64,
+         * so constructing a map costs no system call
+         */
+        inline uint64_t next_seed() noexcept {
+            static const uint64_t base = [] {
+                std::random_device rd;
+                return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+            }();
+            static std::atomic<uint64_t> counter{0};
+            const uint64_t n = counter.fetch_add(1, std::memory_order_relaxed);
+            return fmix64(base ^ fmix64(n + detail::wy_secret[0]));
+        }
+    }
+
+    /**
+     * @brief wyhash keyed with a random per-instance seed (see Flooding above)
+     * The seed travels with the map when it is moved; pass one explicitly for reproducible runs
+     */
+    template <typename T>
+    struct seeded_hasher {
+        uint64_t seed;
+
+        seeded_hasher() noexcept : seed(hashes::next_seed()) {}
+        explicit seeded_hasher(uint64_t s) noexcept : seed(s) {}
+
+        size_t operator()(const T& value) const noexcept {
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                return static_cast<size_t>(hashes::wyhash64(static_cast<uint64_t>(value), seed));
+            } else if constexpr (std::is_pointer_v<T>) {
+                return static_cast<size_t>(hashes::wyhash64(reinterpret_cast<uintptr_t>(value), seed));
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                return static_cast<size_t>(hashes::wyhash(value.data(), value.size(), seed));
+            } else {
+                return static_cast<size_t>(hashes::wyhash(&value, sizeof(T), seed));
+            }
+        }
+    };
+}
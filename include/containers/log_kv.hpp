@@ -0,0 +1,886 @@
+#pragma once
+#if defined(__unix__) || defined(__APPLE__)
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hash.hpp"
+#include "map.hpp"
+
+/**
+ * @brief Log-structured key-value store (Bitcask model) indexed by a shared::map
+ *
+ * Directory layout:
+ * - NNNNNNNN.log segments of records: checksum (wyhash of the rest), sequence number,
+ *   key size, value size (UINT32_MAX for a tombstone), key, value
+ * - NNNNNNNN.hint next to every sealed segment: an entry count, (sequence, offset, sizes,
+ *   key) per record and a trailing checksum, so startup presizes the index and rebuilds
+ *   it without reading values
+ * - The highest-numbered segment is the active one when it has no hint; all writes
+ *   append to it. Merge outputs take ids above it, so after a crash the old active
+ *   segment can sit below hinted segments: recovery then scans it once, seals it and
+ *   writes its hint, and a fresh active segment is created
+ *
+ * Algorithm:
+ * - The index maps key -> (segment, offset, size, sequence) in memory; a get is one
+ *   index probe and one pread of the record, whose checksum is verified
+ * - Group commit: puts append to an in-memory batch and return its sequence number;
+ *   wait_durable(seq) makes the first waiter write the whole batch and fdatasync once
+ *   while later puts gather into the next batch. A background thread also commits any
+ *   batch older than commit_interval, or callers can rely on commit_bytes
+ * - The active segment is sealed (fsynced, hint written) once it reaches segment_bytes
+ * - Compaction copies the still-indexed records of sealed segments whose dead fraction
+ *   exceeds compact_garbage into fresh segments, repoints the index and unlinks the old
+ *   files; it runs on the background thread or through compact()
+ * - Records keep their sequence numbers when merged, so recovery resolves duplicates
+ *   left by a crash mid-merge by keeping the highest one; a torn tail (checksum
+ *   mismatch) in a scanned segment is truncated
+ *
+ * Performance characteristics:
+ * - Puts are sequential appends; with N concurrent durable writers one fdatasync is
+ *   shared by up to N puts
+ * - The index holds every key in memory (Bitcask's trade-off): ~60 bytes plus the key
+ *   per entry at the map's load factor
+ * - Recovery reads hint files only (keys, not values) for sealed segments; a segment
+ *   found without a hint is scanned once and gets one
+ *
+ * Limitations:
+ * - One mutex guards the index and batch; preads and segment I/O run outside it
+ * - Tombstones stay in the index (and are copied by compaction) for good
+ * - Keys and values are byte strings below 4 GB; a process must not share a directory
+ * - OS failures throw std::system_error; corrupt records on get std::runtime_error
+ */
+
+namespace shared {
+    struct log_kv_options {
+        size_t segment_bytes = size_t(64) << 20;         // The active segment is sealed past this size
+        size_t commit_bytes = size_t(1) << 20;           // Batch size that triggers a commit inside put()
+        std::chrono::microseconds commit_interval{2000}; // Background commit period for buffered puts
+        bool sync = true;                                // fdatasync on every commit (false: write only)
+        double compact_garbage = 0.5;                    // Dead fraction that makes a sealed segment a merge victim
+        bool background_compaction = true;
+    };
+
+    struct log_kv_stats {
+        uint64_t puts = 0;
+        uint64_t gets = 0;
+        uint64_t erases = 0;
+        uint64_t commits = 0;          // Group commits (one write + fdatasync each)
+        uint64_t bytes_appended = 0;
+        uint64_t compactions = 0;
+        uint64_t segments_merged = 0;
+        uint64_t bytes_reclaimed = 0;
+        uint64_t segments_from_hints = 0;  // Recovery: segments indexed from hint files
+        uint64_t segments_scanned = 0;     // Recovery: segments indexed by reading the log
+    };
+
+    class log_kv {
+    private:
+        struct record_header {
+            uint64_t checksum;  // wyhash of the bytes after this field (rest of header, key, value)
+            uint64_t seq;
+            uint32_t key_size;
+            uint32_t value_size;
+        };
+
+        struct hint_entry {
+            uint64_t seq;
+            uint64_t offset;
+            uint32_t key_size;
+            uint32_t value_size;
+        };
+
+        struct location {
+            uint64_t seq;
+            uint64_t offset;      // Record start within the segment
+            uint32_t segment;
+            uint32_t value_size;  // tombstone for erased keys
+        };
+
+        struct segment {
+            uint32_t id;
+            int fd = -1;
+            uint64_t bytes = 0;       // Appended, including records still in the batch
+            uint64_t written = 0;     // Written to the file
+            uint64_t live_bytes = 0;  // Records the index points at
+            bool sealed = false;
+
+            explicit segment(uint32_t i) : id(i) {}
+            ~segment() { if (fd >= 0) ::close(fd); }
+            segment(const segment&) = delete;
+            segment& operator=(const segment&) = delete;
+        };
+
+        using segment_ptr = std::shared_ptr<segment>;
+
+        static constexpr uint32_t tombstone = UINT32_MAX;
+        static constexpr uint64_t checksum_seed = 0x6c6f675f6b76ull;
+        static constexpr uint64_t hint_magic = 0x544e49485f4b4c42ull;  // "BLK_HINT"
+
+        std::string _dir;
+        log_kv_options _options;
+        map<std::string, location, 8, seeded_hasher<std::string>> _index;
+        size_t _live;
+        std::vector<segment_ptr> _segments;  // By id; null once merged away
+        segment_ptr _active;
+        std::vector<char> _active_hints;     // Hint entries of the active segment
+        std::vector<char> _pending;          // Batch: appended records not yet handed to a commit
+        std::vector<char> _writing;          // Batch being written by the current commit
+        uint64_t _seq;
+        uint64_t _durable_seq;
+        uint32_t _next_id;
+        bool _committing;
+        bool _rolling;
+        bool _compacting;
+        bool _stop;
+        log_kv_stats _stats;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _committed;  // Commit, roll or compaction finished
+        std::condition_variable _wake;       // Background thread
+        std::thread _background;
+
+        [[noreturn]] static void fail(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        static uint64_t record_bytes(size_t key_size, uint32_t value_size) noexcept {
+            return sizeof(record_header) + key_size + (value_size == tombstone ? 0 : value_size);
+        }
+
+        static uint64_t checksum(const char* record, size_t bytes) noexcept {
+            return hashes::wyhash(record + sizeof(uint64_t), bytes - sizeof(uint64_t), checksum_seed);
+        }
+
+        static void write_all(int fd, const char* data, size_t n, uint64_t offset) {
+            while (n > 0) {
+                const ssize_t w = ::pwrite(fd, data, n, static_cast<off_t>(offset));
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    fail("log_kv: pwrite");
+                }
+                data += w;
+                n -= static_cast<size_t>(w);
+                offset += static_cast<uint64_t>(w);
+            }
+        }
+
+        static void read_all(int fd, char* data, size_t n, uint64_t offset) {
+            while (n > 0) {
+                const ssize_t r = ::pread(fd, data, n, static_cast<off_t>(offset));
+                if (r < 0) {
+                    if (errno == EINTR) continue;
+                    fail("log_kv: pread");
+                }
+                if (r == 0) throw std::runtime_error("log_kv: record past end of segment");
+                data += r;
+                n -= static_cast<size_t>(r);
+                offset += static_cast<uint64_t>(r);
+            }
+        }
+
+        static void sync_fd(int fd) {
+#if defined(__linux__)
+            if (::fdatasync(fd) != 0) fail("log_kv: fdatasync");
+#else
+            if (::fsync(fd) != 0) fail("log_kv: fsync");
+#endif
+        }
+
+        void sync_dir() const {
+            const int fd = ::open(_dir.c_str(), O_RDONLY);
+            if (fd < 0) fail("log_kv: open directory");
+            const int rc = ::fsync(fd);
+            ::close(fd);
+            if (rc != 0) fail("log_kv: fsync directory");
+        }
+
+        std::string file_path(uint32_t id, const char* extension) const {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%08u.%s", id, extension);
+            return (std::filesystem::path(_dir) / name).string();
+        }
+
+        segment_ptr create_segment(uint32_t id) {
+            auto s = std::make_shared<segment>(id);
+            s->fd = ::open(file_path(id, "log").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (s->fd < 0) fail("log_kv: create segment");
+            return s;
+        }
+
+        static void add_hint(std::vector<char>& hints, uint64_t seq, uint64_t offset,
+                             std::string_view key, uint32_t value_size) {
+            const hint_entry e{seq, offset, static_cast<uint32_t>(key.size()), value_size};
+            const size_t at = hints.size();
+            hints.resize(at + sizeof(e) + key.size());
+            std::memcpy(hints.data() + at, &e, sizeof(e));
+            std::memcpy(hints.data() + at + sizeof(e), key.data(), key.size());
+        }
+
+        /**
+         * @brief Writes id.hint atomically (temp file, fsync, rename)
+         */
+        void write_hint(uint32_t id, const std::vector<char>& entries) const {
+            uint64_t count = 0;
+            for (size_t at = 0; at < entries.size(); count++) {
+                hint_entry e;
+                std::memcpy(&e, entries.data() + at, sizeof(e));
+                at += sizeof(e) + e.key_size;
+            }
+            std::vector<char> file(sizeof(uint64_t[3]) + entries.size() + sizeof(uint64_t));
+            const uint64_t head[3] = {hint_magic, id, count};
+            std::memcpy(file.data(), head, sizeof(head));
+            if (!entries.empty()) std::memcpy(file.data() + sizeof(head), entries.data(), entries.size());
+            const size_t body = file.size() - sizeof(uint64_t);
+            const uint64_t sum = hashes::wyhash(file.data(), body, checksum_seed);
+            std::memcpy(file.data() + body, &sum, sizeof(sum));
+
+            const std::string tmp = file_path(id, "hint.tmp");
+            const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) fail("log_kv: create hint");
+            try {
+                write_all(fd, file.data(), file.size(), 0);
+                sync_fd(fd);
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+            if (std::rename(tmp.c_str(), file_path(id, "hint").c_str()) != 0) fail("log_kv: rename hint");
+        }
+
+        // Index
+
+        void apply(std::string_view key, const location& loc) {
+            auto r = _index.try_emplace(std::string(key), loc);
+            if (!r.second && r.first->seq < loc.seq) *r.first = loc;
+        }
+
+        /**
+         * @brief Points key at a newly appended record, retiring the one it replaces
+         */
+        void index_record(std::string_view key, const location& loc) {
+            auto r = _index.try_emplace(std::string(key), loc);
+            if (r.second) {
+                _live += loc.value_size != tombstone;
+                return;
+            }
+            location& old = *r.first;
+            if (old.segment < _segments.size() && _segments[old.segment]) {
+                _segments[old.segment]->live_bytes -= record_bytes(key.size(), old.value_size);
+            }
+            _live += (loc.value_size != tombstone) - static_cast<size_t>(old.value_size != tombstone);
+            old = loc;
+        }
+
+        // Recovery
+
+        /**
+         * @brief Entry count from the header of id.hint, 0 when missing or unreadable
+         */
+        uint64_t hint_count(uint32_t id) const {
+            const int fd = ::open(file_path(id, "hint").c_str(), O_RDONLY);
+            if (fd < 0) return 0;
+            uint64_t head[3] = {};
+            const ssize_t n = ::pread(fd, head, sizeof(head), 0);
+            ::close(fd);
+            return n == static_cast<ssize_t>(sizeof(head)) && head[0] == hint_magic && head[1] == id ? head[2] : 0;
+        }
+
+        bool load_hint(segment& s) {
+            const std::string path = file_path(s.id, "hint");
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            std::vector<char> file;
+            try {
+                if (::fstat(fd, &st) != 0) fail("log_kv: fstat hint");
+                file.resize(static_cast<size_t>(st.st_size));
+                read_all(fd, file.data(), file.size(), 0);
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+
+            if (file.size() < 4 * sizeof(uint64_t)) return false;
+            const size_t body = file.size() - sizeof(uint64_t);
+            uint64_t head[3], sum;
+            std::memcpy(head, file.data(), sizeof(head));
+            std::memcpy(&sum, file.data() + body, sizeof(sum));
+            if (head[0] != hint_magic || head[1] != s.id || sum != hashes::wyhash(file.data(), body, checksum_seed)) {
+                return false;
+            }
+            // Validate every entry before touching the index
+            for (size_t at = sizeof(head); at < body; ) {
+                hint_entry e;
+                if (at + sizeof(e) > body) return false;
+                std::memcpy(&e, file.data() + at, sizeof(e));
+                if (at + sizeof(e) + e.key_size > body || e.offset + record_bytes(e.key_size, e.value_size) > s.bytes) {
+                    return false;
+                }
+                at += sizeof(e) + e.key_size;
+            }
+            for (size_t at = sizeof(head); at < body; ) {
+                hint_entry e;
+                std::memcpy(&e, file.data() + at, sizeof(e));
+                apply(std::string_view(file.data() + at + sizeof(e), e.key_size),
+                      location{e.seq, e.offset, s.id, e.value_size});
+                _seq = std::max(_seq, e.seq);
+                at += sizeof(e) + e.key_size;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Indexes a segment by reading its records; truncates a torn tail
+         * @param hints Receives hint entries when not null
+         */
+        void scan_segment(segment& s, std::vector<char>* hints) {
+            std::vector<char> data(static_cast<size_t>(s.bytes));
+            if (!data.empty()) read_all(s.fd, data.data(), data.size(), 0);
+            uint64_t at = 0;
+            while (at + sizeof(record_header) <= data.size()) {
+                record_header h;
+                std::memcpy(&h, data.data() + at, sizeof(h));
+                const uint64_t bytes = record_bytes(h.key_size, h.value_size);
+                if (at + bytes > data.size() || h.checksum != checksum(data.data() + at, bytes)) break;
+                const std::string_view key(data.data() + at + sizeof(h), h.key_size);
+                apply(key, location{h.seq, at, s.id, h.value_size});
+                if (hints) add_hint(*hints, h.seq, at, key, h.value_size);
+                _seq = std::max(_seq, h.seq);
+                at += bytes;
+            }
+            if (at < s.bytes) {
+                if (::ftruncate(s.fd, static_cast<off_t>(at)) != 0) fail("log_kv: ftruncate");
+                s.bytes = at;
+            }
+        }
+
+        void recover() {
+            std::vector<uint32_t> ids;
+            for (const auto& entry : std::filesystem::directory_iterator(_dir)) {
+                const auto& p = entry.path();
+                const std::string stem = p.stem().string();
+                if (p.extension() == ".log" && !stem.empty() &&
+                    stem.find_first_not_of("0123456789") == std::string::npos) {
+                    ids.push_back(static_cast<uint32_t>(std::stoul(stem)));
+                } else if (p.extension() == ".tmp") {
+                    std::filesystem::remove(p);
+                }
+            }
+            std::sort(ids.begin(), ids.end());
+
+            // Size the index once instead of doubling through every hinted record
+            uint64_t hinted = 0;
+            for (uint32_t id : ids) hinted += hint_count(id);
+            if (hinted > 0) _index.reserve(static_cast<size_t>(hinted));
+
+            bool wrote_hints = false;
+            for (size_t i = 0; i < ids.size(); i++) {
+                auto s = std::make_shared<segment>(ids[i]);
+                s->fd = ::open(file_path(ids[i], "log").c_str(), O_RDWR);
+                if (s->fd < 0) fail("log_kv: open segment");
+                struct stat st;
+                if (::fstat(s->fd, &st) != 0) fail("log_kv: fstat segment");
+                s->bytes = static_cast<uint64_t>(st.st_size);
+
+                if (load_hint(*s)) {
+                    s->sealed = true;
+                    _stats.segments_from_hints++;
+                } else {
+                    // Only the newest segment stays open for appends. An unhinted one below
+                    // it (an active segment that a crash left under merge outputs, or a
+                    // hint lost mid-roll) is sealed now, hint included, so the next open
+                    // does not scan it again
+                    const bool last = i + 1 == ids.size();
+                    std::vector<char> hints;
+                    scan_segment(*s, last ? &_active_hints : &hints);
+                    s->sealed = !last;
+                    if (!last) {
+                        sync_fd(s->fd);
+                        write_hint(s->id, hints);
+                        wrote_hints = true;
+                    }
+                    _stats.segments_scanned++;
+                }
+                s->written = s->bytes;
+                if (_segments.size() <= s->id) _segments.resize(s->id + 1);
+                _segments[s->id] = s;
+            }
+            if (wrote_hints) sync_dir();
+            _next_id = ids.empty() ? 0 : ids.back() + 1;
+
+            for (auto& e : _index) {
+                _segments[e.second.segment]->live_bytes += record_bytes(e.first.size(), e.second.value_size);
+                _live += e.second.value_size != tombstone;
+            }
+
+            if (!ids.empty() && !_segments[ids.back()]->sealed) {
+                _active = _segments[ids.back()];
+            } else {
+                _active_hints.clear();
+                _active = create_segment(_next_id++);
+                _segments.resize(_active->id + 1);
+                _segments[_active->id] = _active;
+                sync_dir();
+            }
+            _durable_seq = _seq;
+        }
+
+        // Writing
+
+        /**
+         * @brief Writes the batch as the committing caller, or waits for the one in progress,
+         * until every record appended before the call is committed
+         */
+        void commit_locked(std::unique_lock<std::mutex>& lock) {
+            const uint64_t target = _seq;
+            while (_durable_seq < target) {
+                if (_committing) {
+                    _committed.wait(lock);
+                    continue;
+                }
+                _writing.swap(_pending);
+                const uint64_t seq = _seq;
+                const segment_ptr s = _active;
+                const uint64_t offset = s->written;
+                _committing = true;
+                lock.unlock();
+                std::exception_ptr error;
+                try {
+                    write_all(s->fd, _writing.data(), _writing.size(), offset);
+                    if (_options.sync) sync_fd(s->fd);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                lock.lock();
+                _committing = false;
+                if (error) {
+                    // Keep the records for the next attempt
+                    _writing.insert(_writing.end(), _pending.begin(), _pending.end());
+                    _pending.swap(_writing);
+                    _writing.clear();
+                    _committed.notify_all();
+                    std::rethrow_exception(error);
+                }
+                s->written += _writing.size();
+                _writing.clear();
+                _durable_seq = seq;
+                _stats.commits++;
+                _committed.notify_all();
+            }
+        }
+
+        /**
+         * @brief Seals the active segment and starts a new one
+         * The fsync, hint write and segment creation run unlocked: appends wait while
+         * _rolling is set, so the active segment and its hints cannot change meanwhile
+         */
+        void roll_locked(std::unique_lock<std::mutex>& lock) {
+            _rolling = true;
+            try {
+                while (_committing || !_pending.empty()) commit_locked(lock);
+                const uint32_t id = _next_id++;
+                lock.unlock();
+                sync_fd(_active->fd);
+                write_hint(_active->id, _active_hints);
+                segment_ptr next = create_segment(id);
+                sync_dir();
+                lock.lock();
+                _active->sealed = true;
+                _active_hints.clear();
+                if (_segments.size() <= next->id) _segments.resize(next->id + 1);
+                _segments[next->id] = next;
+                _active = std::move(next);
+            } catch (...) {
+                if (!lock.owns_lock()) lock.lock();
+                _rolling = false;
+                _committed.notify_all();
+                throw;
+            }
+            _rolling = false;
+            _committed.notify_all();
+            _wake.notify_one();
+        }
+
+        uint64_t append_locked(std::unique_lock<std::mutex>& lock, std::string_view key,
+                               const char* value, uint32_t value_size) {
+            const uint64_t bytes = record_bytes(key.size(), value_size);
+            for (;;) {
+                while (_rolling) _committed.wait(lock);
+                if (_active->bytes == 0 || _active->bytes + bytes <= _options.segment_bytes) break;
+                roll_locked(lock);
+            }
+
+            const record_header h{0, ++_seq, static_cast<uint32_t>(key.size()), value_size};
+            const uint64_t offset = _active->bytes;
+            const size_t at = _pending.size();
+            _pending.resize(at + static_cast<size_t>(bytes));
+            char* p = _pending.data() + at;
+            std::memcpy(p, &h, sizeof(h));
+            std::memcpy(p + sizeof(h), key.data(), key.size());
+            if (value_size != tombstone) std::memcpy(p + sizeof(h) + key.size(), value, value_size);
+            const uint64_t sum = checksum(p, static_cast<size_t>(bytes));
+            std::memcpy(p, &sum, sizeof(sum));
+
+            _active->bytes += bytes;
+            _active->live_bytes += bytes;
+            add_hint(_active_hints, h.seq, offset, key, value_size);
+            index_record(key, location{h.seq, offset, _active->id, value_size});
+            _stats.bytes_appended += bytes;
+
+            const uint64_t seq = h.seq;
+            if (_pending.size() >= _options.commit_bytes) commit_locked(lock);
+            return seq;
+        }
+
+        // Compaction
+
+        bool is_victim(const segment& s) const noexcept {
+            return s.sealed && s.bytes > 0 &&
+                   static_cast<double>(s.bytes - s.live_bytes) > _options.compact_garbage * static_cast<double>(s.bytes);
+        }
+
+        bool has_victims_locked() const noexcept {
+            for (const auto& s : _segments) {
+                if (s && is_victim(*s)) return true;
+            }
+            return false;
+        }
+
+        struct merge_output {
+            segment_ptr seg;
+            std::vector<char> data;
+            std::vector<char> hints;
+        };
+
+        struct merge_move {
+            uint32_t from;
+            uint64_t from_offset;
+            size_t output;
+            uint64_t to_offset;
+        };
+
+        /**
+         * @brief Copies the live records of victims into new segments; called unlocked,
+         * returns with the lock held after the index and segment table are switched over
+         */
+        void merge(const std::vector<segment_ptr>& victims, std::unique_lock<std::mutex>& lock) {
+            std::vector<merge_output> outputs;
+            std::vector<merge_move> moves;
+            std::vector<char> data;
+            std::vector<uint64_t> offsets;
+
+            for (const auto& victim : victims) {
+                data.resize(static_cast<size_t>(victim->bytes));
+                if (!data.empty()) read_all(victim->fd, data.data(), data.size(), 0);
+
+                offsets.clear();
+                for (uint64_t at = 0; at + sizeof(record_header) <= data.size(); ) {
+                    record_header h;
+                    std::memcpy(&h, data.data() + at, sizeof(h));
+                    offsets.push_back(at);
+                    at += record_bytes(h.key_size, h.value_size);
+                }
+
+                // Check liveness in short critical sections so puts and gets keep flowing
+                constexpr size_t chunk = 1024;
+                for (size_t first = 0; first < offsets.size(); first += chunk) {
+                    const size_t last = std::min(offsets.size(), first + chunk);
+                    lock.lock();
+                    size_t kept = first;
+                    for (size_t i = first; i < last; i++) {
+                        record_header h;
+                        std::memcpy(&h, data.data() + offsets[i], sizeof(h));
+                        const location* loc = _index.find(std::string(data.data() + offsets[i] + sizeof(h), h.key_size));
+                        if (loc && loc->segment == victim->id && loc->offset == offsets[i]) offsets[kept++] = offsets[i];
+                    }
+                    lock.unlock();
+
+                    for (size_t i = first; i < kept; i++) {
+                        record_header h;
+                        const char* rec = data.data() + offsets[i];
+                        std::memcpy(&h, rec, sizeof(h));
+                        const uint64_t bytes = record_bytes(h.key_size, h.value_size);
+                        if (outputs.empty() || (!outputs.back().data.empty() &&
+                                                outputs.back().data.size() + bytes > _options.segment_bytes)) {
+                            outputs.emplace_back();
+                        }
+                        merge_output& out = outputs.back();
+                        const uint64_t to = out.data.size();
+                        out.data.insert(out.data.end(), rec, rec + bytes);
+                        add_hint(out.hints, h.seq, to, std::string_view(rec + sizeof(h), h.key_size), h.value_size);
+                        moves.push_back(merge_move{victim->id, offsets[i], outputs.size() - 1, to});
+                    }
+                }
+            }
+
+            lock.lock();
+            for (auto& out : outputs) out.seg = std::make_shared<segment>(_next_id++);
+            lock.unlock();
+
+            for (auto& out : outputs) {
+                out.seg->fd = ::open(file_path(out.seg->id, "log").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (out.seg->fd < 0) fail("log_kv: create segment");
+                write_all(out.seg->fd, out.data.data(), out.data.size(), 0);
+                sync_fd(out.seg->fd);
+                write_hint(out.seg->id, out.hints);
+                out.seg->bytes = out.seg->written = out.data.size();
+                out.seg->sealed = true;
+            }
+            if (!outputs.empty()) sync_dir();
+
+            lock.lock();
+            for (const merge_move& m : moves) {
+                const merge_output& out = outputs[m.output];
+                record_header h;
+                std::memcpy(&h, out.data.data() + m.to_offset, sizeof(h));
+                location* loc = _index.find(std::string(out.data.data() + m.to_offset + sizeof(h), h.key_size));
+                if (loc && loc->segment == m.from && loc->offset == m.from_offset) {
+                    loc->segment = out.seg->id;
+                    loc->offset = m.to_offset;
+                    out.seg->live_bytes += record_bytes(h.key_size, h.value_size);
+                }
+            }
+            uint64_t reclaimed = 0;
+            for (const auto& victim : victims) {
+                reclaimed += victim->bytes;
+                _segments[victim->id].reset();
+                std::remove(file_path(victim->id, "hint").c_str());
+                std::remove(file_path(victim->id, "log").c_str());
+            }
+            for (auto& out : outputs) {
+                reclaimed -= out.seg->bytes;
+                if (_segments.size() <= out.seg->id) _segments.resize(out.seg->id + 1);
+                _segments[out.seg->id] = out.seg;
+            }
+            _stats.compactions++;
+            _stats.segments_merged += victims.size();
+            _stats.bytes_reclaimed += reclaimed;
+        }
+
+        void background() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stop) {
+                _wake.wait_for(lock, _options.commit_interval);
+                if (_stop) break;
+                try {
+                    if (!_pending.empty() && !_committing && !_rolling) commit_locked(lock);
+                    if (_options.background_compaction && !_compacting && has_victims_locked()) {
+                        lock.unlock();
+                        compact();
+                        lock.lock();
+                    }
+                } catch (...) {
+                    // Foreground commits retry and report; compaction retries on the next wake
+                    if (!lock.owns_lock()) lock.lock();
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Opens (creating if needed) the store in directory dir and rebuilds its index
+         */
+        explicit log_kv(const std::string& dir, const log_kv_options& options = log_kv_options())
+            : _dir(dir), _options(options), _live(0), _seq(0), _durable_seq(0), _next_id(0),
+              _committing(false), _rolling(false), _compacting(false), _stop(false) {
+            if (options.segment_bytes == 0 || options.commit_bytes == 0 || options.compact_garbage < 0) {
+                throw std::invalid_argument("log_kv: segment_bytes and commit_bytes must be positive");
+            }
+            std::filesystem::create_directories(_dir);
+            recover();
+            _background = std::thread([this] { background(); });
+        }
+
+        /**
+         * @brief Commits the batch and seals the active segment with a hint, so the next
+         * open reads hints only (best effort; errors are swallowed)
+         */
+        ~log_kv() noexcept {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            if (_background.joinable()) _background.join();
+            try {
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (_committing || !_pending.empty()) commit_locked(lock);
+                if (_active->bytes == 0) {
+                    const uint32_t id = _active->id;
+                    _active.reset();
+                    _segments[id].reset();
+                    std::remove(file_path(id, "log").c_str());
+                } else {
+                    sync_fd(_active->fd);
+                    write_hint(_active->id, _active_hints);
+                }
+            } catch (...) {
+            }
+        }
+
+        log_kv(const log_kv&) = delete;
+        log_kv& operator=(const log_kv&) = delete;
+
+        /**
+         * @brief Appends key = value to the batch
+         * @return Sequence number to pass to wait_durable()
+         */
+        uint64_t put(std::string_view key, std::string_view value) {
+            if (key.size() >= tombstone || value.size() >= tombstone) {
+                throw std::length_error("log_kv: keys and values must be smaller than 4 GB");
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stats.puts++;
+            return append_locked(lock, key, value.data(), static_cast<uint32_t>(value.size()));
+        }
+
+        /**
+         * @brief Appends a tombstone for key if it is present; sync() makes it durable
+         */
+        bool erase(std::string_view key) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            const location* loc = _index.find(std::string(key));
+            if (!loc || loc->value_size == tombstone) return false;
+            _stats.erases++;
+            append_locked(lock, key, nullptr, tombstone);
+            return true;
+        }
+
+        std::optional<std::string> get(std::string_view key) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stats.gets++;
+            const location* found = _index.find(std::string(key));
+            if (!found || found->value_size == tombstone) return std::nullopt;
+            const location loc = *found;
+            const segment_ptr s = _segments[loc.segment];
+            std::string value(loc.value_size, '\0');
+
+            if (loc.offset >= s->written) {
+                // Still in the batch (records never straddle the two buffers)
+                const uint64_t at = loc.offset - s->written;
+                const char* rec = at < _writing.size() ? _writing.data() + at : _pending.data() + (at - _writing.size());
+                std::memcpy(value.data(), rec + sizeof(record_header) + key.size(), loc.value_size);
+                return value;
+            }
+            lock.unlock();
+
+            const size_t bytes = static_cast<size_t>(record_bytes(key.size(), loc.value_size));
+            std::vector<char> rec(bytes);
+            read_all(s->fd, rec.data(), bytes, loc.offset);
+            uint64_t sum;
+            std::memcpy(&sum, rec.data(), sizeof(sum));
+            if (sum != checksum(rec.data(), bytes)) throw std::runtime_error("log_kv: record checksum mismatch");
+            std::memcpy(value.data(), rec.data() + sizeof(record_header) + key.size(), loc.value_size);
+            return value;
+        }
+
+        bool contains(std::string_view key) const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            const location* loc = _index.find(std::string(key));
+            return loc && loc->value_size != tombstone;
+        }
+
+        /**
+         * @brief Blocks until the record with sequence number seq (and all before it) is
+         * committed; joins or leads a group commit
+         */
+        void wait_durable(uint64_t seq) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (_durable_seq < seq) commit_locked(lock);
+        }
+
+        /**
+         * @brief Commits everything appended so far
+         */
+        void sync() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            commit_locked(lock);
+        }
+
+        /**
+         * @brief Runs one merge pass over sealed segments above the garbage threshold
+         * @return Number of segments merged away
+         */
+        size_t compact() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (_compacting) _committed.wait(lock);
+            std::vector<segment_ptr> victims;
+            for (const auto& s : _segments) {
+                if (s && is_victim(*s)) victims.push_back(s);
+            }
+            if (victims.empty()) return 0;
+            _compacting = true;
+            lock.unlock();
+            try {
+                merge(victims, lock);
+            } catch (...) {
+                if (!lock.owns_lock()) lock.lock();
+                _compacting = false;
+                _committed.notify_all();
+                throw;
+            }
+            _compacting = false;
+            _committed.notify_all();
+            return victims.size();
+        }
+
+        size_t size() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _live;
+        }
+
+        size_t segment_count() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            size_t n = 0;
+            for (const auto& s : _segments) n += s != nullptr;
+            return n;
+        }
+
+        /**
+         * @brief Bytes held by segment files (including the uncommitted batch)
+         */
+        uint64_t disk_bytes() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            uint64_t bytes = 0;
+            for (const auto& s : _segments) {
+                if (s) bytes += s->bytes;
+            }
+            return bytes;
+        }
+
+        log_kv_stats stats() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _stats;
+        }
+
+        void reset_stats() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stats = log_kv_stats();
+        }
+
+        const std::string& directory() const noexcept { return _dir; }
+    };
+}
+#endif
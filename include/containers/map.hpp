@@ -1,4 +1,22 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "amac.hpp"
+#include "prefetch.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 /**
  * @brief A custom hash map implementation optimized for performance and memory usage
@@ -16,8 +34,14 @@
  * Pros:
  * - Fast lookups and insertions in the average case
  * - Memory efficient due to contiguous storage
- * - Move-only semantics prevent accidental copies
+ * - Move-only semantics prevent accidental copies; clone() makes explicit deep copies
  * - Custom pair implementation reduces overhead
+ *
+ * Slot storage:
+ * - When k and v are trivially copyable, so are the slots: rehash relocates slots with
+ *   memcpy and clone() copies the whole array into uninitialized storage with one memcpy
+ * - Other trivially relocatable pairs (see is_trivially_relocatable) are also
+ *   relocated with memcpy on rehash
  * 
  * Cons:
  * - Worse worst-case performance (O(n) vs O(log n) for std::map)
@@ -25,6 +49,31 @@
  * - Limited to types that can be efficiently hashed
  * - Current hash function may have clustering issues
  * 
+ * Prehashed API:
+ * - hash_of(key) exposes the table's hash so callers compute it once and reuse it
+ *   (shard selection, bloom filters) before find_hashed/try_emplace_hashed
+ * - upsert/update probe once and only grow the table on an actual insertion
+ * 
+ * Set algebra:
+ * - merge(map&&) sizes the table once for the estimated union and relocates the other
+ *   map's elements with one hash each
+ * - intersect/subtract/retain_if rebuild the table from the survivors (there are no
+ *   tombstones); occupancy is scanned 64 slots per bitmask
+ * 
+ * Parallel scans:
+ * - ranges(n) splits the slots into n disjoint block-aligned ranges, each iterable on
+ *   its own thread (see parallel_for_each in parallel.hpp)
+ * 
+ * Load factor:
+ * - The growth threshold is set at runtime through load_policy (0.75 by default)
+ * - With min_load < max_load the map samples probe lengths and misses in find_slot
+ *   (1/16 of keys, picked by a multiplicative mix of the hash) and, every `window`
+ *   samples, lowers the threshold when the mean probe length exceeds target_probes
+ *   or raises it when probes are short; a high miss ratio caps it lower because
+ *   misses walk to an empty slot. New limits take effect at the next insertion
+ * - Adaptive maps update their counters from const find(), so unlike fixed-policy
+ *   maps they are not safe for concurrent readers
+ * 
  * Potential improvements:
  * - Add proper exception handling
  * - Implement erase() functionality
@@ -36,7 +85,10 @@
 
 namespace shared {
     /**
-     * @brief Custom pair implementation optimized for move semantics
+     * @brief Custom pair with defaulted copy/move, so pair<k, v> (and a map slot holding
+     * one) is trivially copyable whenever k and v are; rehash and clone then move slots
+     * with memcpy. Members are public, so structured bindings work directly:
+     * `auto [value, inserted] = m.try_emplace(key);`
      * @tparam t1 Type of first element
      * @tparam t2 Type of second element
      */
@@ -44,32 +96,37 @@ namespace shared {
     class pair {
     public:
         pair() : first(), second() {}
-        
+
         template<typename T1, typename T2>
-        pair(T1&& f, T2&& s) noexcept 
+        pair(T1&& f, T2&& s) noexcept(std::is_nothrow_constructible_v<t1, T1&&> &&
+                                      std::is_nothrow_constructible_v<t2, T2&&>)
             : first(std::forward<T1>(f))
             , second(std::forward<T2>(s)) {}
-        
-        pair(pair&& other) noexcept 
-            : first(std::move(other.first))
-            , second(std::move(other.second)) {}
-        
-        pair& operator=(pair&& other) noexcept {
-            if (this != &other) {
-                first = std::move(other.first);
-                second = std::move(other.second);
-            }
-            return *this;
-        }
 
-        // Prevent copying to enforce move semantics
-        pair(const pair&) = delete;
-        pair& operator=(const pair&) = delete;
+        pair(const pair&) = default;
+        pair(pair&&) = default;
+        pair& operator=(const pair&) = default;
+        pair& operator=(pair&&) = default;
+        ~pair() = default;
 
         t1 first;
         t2 second;
     };
 
+    /**
+     * @brief Types that can be moved to new storage with memcpy, leaving the source
+     * without running its destructor
+     * True for trivially copyable types. Specialize for others where the contract also
+     * holds that a value-initialized object owns nothing (the map overwrites such
+     * objects in place); pair is relocatable when both members are
+     */
+    template <typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <typename t1, typename t2>
+    struct is_trivially_relocatable<pair<t1, t2>>
+        : std::bool_constant<is_trivially_relocatable<t1>::value && is_trivially_relocatable<t2>::value> {};
+
     /**
      * @brief Rolling hash function optimized for integer and pointer types
      * Uses FNV-1a inspired algorithm for good distribution
@@ -84,13 +141,81 @@ namespace shared {
         return hash;
     }
 
+    /**
+     * @brief Default hasher for map, forwards to hash_fn
+     * Alternative hashers (see hash.hpp) can be supplied as the map's Hash parameter
+     */
+    template <typename T>
+    struct hasher {
+        size_t operator()(const T& value) const noexcept { return hash_fn(value); }
+    };
+
+    /**
+     * @brief Strings hash their characters; the object bytes hold a heap or SSO pointer,
+     * which would give equal strings different hashes
+     */
+    template <>
+    struct hasher<std::string> {
+        size_t operator()(const std::string& value) const noexcept {
+            size_t hash = 0;
+            for (unsigned char c : value) {
+                hash = ((hash << 5) + hash) + c;
+            }
+            return hash;
+        }
+    };
+
+    /**
+     * @brief Growth threshold settings for map
+     * min_load == max_load fixes the threshold; min_load < max_load tunes it online.
+     * An adaptive map updates its counters from const lookups, so it is not safe for
+     * concurrent readers; share a fixed-policy map between threads instead
+     */
+    struct load_policy {
+        float min_load = 0.75f;
+        float max_load = 0.75f;
+        float target_probes = 2.5f;  // Mean slots inspected per probe the tuner aims for
+        uint32_t window = 1024;      // Sampled probes between threshold adjustments
+
+        bool adaptive() const noexcept { return min_load < max_load; }
+    };
+
+    /**
+     * @brief Probe counters sampled by a map with an adaptive load_policy
+     */
+    struct probe_stats {
+        uint64_t lookups = 0;
+        uint64_t probes = 0;
+        uint64_t misses = 0;  // Probes that ended on an empty slot (absent key or insertion)
+
+        double mean_probes() const noexcept { return lookups ? static_cast<double>(probes) / lookups : 0.0; }
+        double miss_ratio() const noexcept { return lookups ? static_cast<double>(misses) / lookups : 0.0; }
+    };
+
+    namespace detail {
+        inline unsigned ctz64(uint64_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanForward64(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            unsigned n = 0;
+            while (!(mask & 1u)) { mask >>= 1; ++n; }
+            return n;
+#endif
+        }
+    }
+
     /**
      * @brief Hash map implementation using open addressing
      * @tparam k Key type
      * @tparam v Value type
      * @tparam InitialSize Initial capacity (must be power of 2)
+     * @tparam Hash Hash function object for keys
      */
-    template <typename k, typename v, size_t InitialSize = 8>
+    template <typename k, typename v, size_t InitialSize = 8, typename Hash = hasher<k>>
     class map {
     private:
         struct Entry {
@@ -107,63 +232,307 @@ namespace shared {
             }
         };
 
+        static constexpr bool trivial_entries =
+            std::is_trivially_copyable_v<Entry> && alignof(Entry) <= alignof(std::max_align_t);
+        static constexpr bool relocatable_entries = is_trivially_relocatable<pair<k, v>>::value;
+        static constexpr uint32_t npos_slot = UINT32_MAX;
+        static constexpr uint32_t prefetch_blocks = 2;  // 64-slot blocks a range scan prefetches ahead
+
+        /**
+         * @brief Array of n slots, empty unless construct is false (trivial slots only,
+         * for callers that overwrite every byte)
+         * Slots are initialized in address order on purpose: lazily zeroed calloc pages
+         * would take a read fault (zero page) and then a copy-on-write fault per page
+         * under the random probe order, which made growth ~30% slower
+         */
+        static Entry* allocate_entries(uint32_t n, bool construct = true) {
+            if constexpr (trivial_entries) {
+                Entry* e = static_cast<Entry*>(::operator new[](sizeof(Entry) * n));
+                if (construct) std::uninitialized_value_construct_n(e, n);
+                return e;
+            } else {
+                return new Entry[n]();
+            }
+        }
+
+        static void free_entries(Entry* e) noexcept {
+            if constexpr (trivial_entries) {
+                ::operator delete[](static_cast<void*>(e));
+            } else {
+                delete[] e;
+            }
+        }
+
         Entry* entries;
         uint32_t capacity;  // Using uint32_t since we're unlikely to need maps larger than 4GB
         uint32_t m_size;    // Current number of occupied slots
-        static constexpr float max_load_factor = 0.75f;
+        Hash m_hash;
+        load_policy m_policy;
+        bool m_adaptive = false;
+        // Written by const lookups when m_adaptive: concurrent readers race on them
+        mutable float m_load_limit = 0.75f;  // Current growth threshold
+        mutable probe_stats m_stats;         // Totals of completed windows
+        mutable probe_stats m_window;
 
         /**
          * @brief Finds slot for key using quadratic probing
          * @return Index where key exists or should be inserted
          */
         size_t find_slot(const k& key) const noexcept {
-            size_t hash = hash_fn(key);
+            return find_slot_hashed(key, m_hash(key));
+        }
+
+        /**
+         * @brief find_slot with the key's hash supplied by the caller
+         */
+        size_t find_slot_hashed(const k& key, size_t hash) const noexcept {
+            size_t probes;
+            size_t index = probe_slot(key, hash, probes);
+            // Sample 1/16 of keys, keeping counter updates off most lookups. The hash's
+            // own top bits are no sample: hash_fn (djb2) leaves them zero for every
+            // integer key. A Fibonacci multiply spreads all bits into the top four
+            if (m_adaptive && ((hash * UINT64_C(0x9E3779B97F4A7C15)) >> 60) == 0) {
+                record_probe(probes, entries[index].state != 1);
+            }
+            return index;
+        }
+
+        /**
+         * @brief Quadratic probe without statistics
+         * @param probes Receives the number of slots inspected
+         */
+        size_t probe_slot(const k& key, size_t hash, size_t& probes) const noexcept {
             size_t index = hash & (capacity - 1);
             
             // Quadratic probing with power of 2 capacity ensures full table coverage
             for (size_t i = 0; ; i++) {
                 if (entries[index].state != 1 || entries[index].data.first == key) {
+                    probes = i + 1;
                     return index;
                 }
                 index = (index + i) & (capacity - 1);
             }
         }
 
+        void record_probe(size_t probes, bool miss) const noexcept {
+            m_window.lookups++;
+            m_window.probes += probes;
+            m_window.misses += miss;
+            if (m_window.lookups >= m_policy.window) {
+                tune();
+            }
+        }
+
+        /**
+         * @brief Moves the growth threshold one step based on the finished window
+         */
+        void tune() const noexcept {
+            constexpr float step = 0.05f;
+            const float span = m_policy.max_load - m_policy.min_load;
+            const float ceiling = m_policy.max_load - span * 0.5f * static_cast<float>(m_window.miss_ratio());
+            const double mean = m_window.mean_probes();
+
+            if (mean > m_policy.target_probes) {
+                m_load_limit -= step;
+            } else if (mean < m_policy.target_probes * 0.8) {
+                m_load_limit += step;
+            }
+            m_load_limit = std::clamp(m_load_limit, m_policy.min_load, ceiling);
+
+            m_stats.lookups += m_window.lookups;
+            m_stats.probes += m_window.probes;
+            m_stats.misses += m_window.misses;
+            m_window = probe_stats();
+        }
+
+        bool over_limit(size_t count) const noexcept {
+            return over_limit_at(count, capacity);
+        }
+
+        bool over_limit_at(size_t count, uint32_t cap) const noexcept {
+            return static_cast<float>(count) / cap > m_load_limit;
+        }
+
         /**
          * @brief Grows hash table and rehashes all elements
-         * Doubles capacity and reinserts all existing elements
+         * Doubles capacity (more if the load limit dropped) and reinserts all existing elements
          */
         void grow() {
+            uint32_t new_cap = capacity * 2;
+            while (static_cast<float>(m_size + 1) / new_cap > m_load_limit) {
+                new_cap *= 2;
+            }
+            rehash(new_cap);
+        }
+
+        /**
+         * @brief Moves src's element into the empty slot dst
+         * src keeps its state; its object is left safe to destroy (moved from, or
+         * value-initialized after a non-trivial memcpy relocation)
+         */
+        static void relocate(Entry& dst, Entry& src) {
+            if constexpr (relocatable_entries) {
+                std::memcpy(static_cast<void*>(&dst), &src, sizeof(Entry));
+                if constexpr (!trivial_entries) {
+                    // The bytes now live in dst; leave an owning-nothing object behind
+                    new (&src.data) pair<k, v>();
+                }
+            } else {
+                dst.insert(std::move(src.data.first), std::move(src.data.second));
+            }
+        }
+
+        /**
+         * @brief Calls fn(i) for each occupied slot i in [first, last) in index order
+         * The state bits sit inside each slot, so there is no control-byte array to
+         * compare 16 at a time; instead each 64-slot block's occupancy mask is built
+         * without branches and walked with ctz, avoiding a mispredicted branch per slot.
+         * With prefetch_ahead, the block prefetch_blocks ahead is requested before each block
+         */
+        template <typename F>
+        void for_each_occupied(F&& fn, uint32_t first = 0, uint32_t last = npos_slot, bool prefetch_ahead = false) const {
+            last = std::min(last, capacity);
+            for (uint32_t base = first; base < last; base += 64) {
+                const uint32_t n = std::min<uint32_t>(64, last - base);
+                const Entry* block = entries + base;
+                if (prefetch_ahead && last - base > 64 * prefetch_blocks) {
+                    const char* ahead = reinterpret_cast<const char*>(block + 64 * prefetch_blocks);
+                    for (size_t offset = 0; offset < 64 * sizeof(Entry); offset += 64) {
+                        prefetch(ahead + offset);
+                    }
+                }
+                uint64_t mask = 0;
+                for (uint32_t j = 0; j < n; j++) {
+                    mask |= static_cast<uint64_t>(block[j].state == 1) << j;
+                }
+                while (mask) {
+                    fn(base + detail::ctz64(mask));
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        /**
+         * @brief Keeps the elements for which keep(key, value, hash) is true
+         * Without tombstones slots cannot be dropped in place, so survivors move (with
+         * the hash already computed for keep) into a new table sized for them
+         * @return Number of elements removed
+         */
+        template <typename Keep>
+        size_t filter(Keep&& keep) {
+            std::vector<uint32_t> slots;
+            std::vector<size_t> hashes;
+            slots.reserve(m_size);
+            hashes.reserve(m_size);
+            for_each_occupied([&](uint32_t i) {
+                const size_t hash = m_hash(entries[i].data.first);
+                if (keep(static_cast<const k&>(entries[i].data.first), entries[i].data.second, hash)) {
+                    slots.push_back(i);
+                    hashes.push_back(hash);
+                }
+            });
+            const size_t removed = m_size - slots.size();
+            if (removed == 0) {
+                return 0;
+            }
+
+            uint32_t new_cap = InitialSize;
+            while (over_limit_at(slots.size(), new_cap)) {
+                new_cap *= 2;
+            }
+            Entry* old_entries = entries;
+            entries = allocate_entries(new_cap);
+            capacity = new_cap;
+            for (size_t i = 0; i < slots.size(); i++) {
+                size_t probes;
+                const size_t index = probe_slot(old_entries[slots[i]].data.first, hashes[i], probes);
+                relocate(entries[index], old_entries[slots[i]]);
+            }
+            free_entries(old_entries);
+            m_size = static_cast<uint32_t>(slots.size());
+            return removed;
+        }
+
+        /**
+         * @brief Size to reserve before merging other, from the share of an evenly spaced
+         * sample of other's slots already present here
+         * Reserving m_size + other.m_size would double the table for overlapping maps
+         */
+        size_t merged_size_estimate(const map& other) const {
+            const uint32_t step = std::max<uint32_t>(1, other.capacity / 1024);
+            size_t sampled = 0;
+            size_t present = 0;
+            for (uint32_t i = 0; i < other.capacity; i += step) {
+                if (other.entries[i].state == 1) {
+                    size_t probes;
+                    const k& key = other.entries[i].data.first;
+                    present += entries[probe_slot(key, m_hash(key), probes)].state == 1;
+                    sampled++;
+                }
+            }
+            if (sampled == 0) {
+                return static_cast<size_t>(m_size) + other.m_size;
+            }
+            // Round the share of new keys down by about two standard errors: undershooting
+            // costs at most one growth during the merge, overshooting doubles the table
+            const double share = static_cast<double>(sampled - present) / sampled;
+            const double margin = 2.0 * std::sqrt(share * (1.0 - share) / sampled);
+            return m_size + static_cast<size_t>(static_cast<double>(other.m_size) * std::max(0.0, share - margin));
+        }
+
+        /**
+         * @brief Whether key is in other, reusing hash when both maps hash identically
+         */
+        template <typename V2, size_t I2, typename H2>
+        static bool contains_in(const map<k, V2, I2, H2>& other, const k& key, size_t hash) {
+            if constexpr (std::is_same_v<H2, Hash> && std::is_empty_v<Hash>) {
+                return other.find_hashed(key, hash) != nullptr;
+            } else {
+                return other.find(key) != nullptr;
+            }
+        }
+
+        void rehash(uint32_t new_cap) {
             uint32_t old_cap = capacity;
             Entry* old_entries = entries;
 
-            capacity *= 2;
-            entries = new Entry[capacity]();
-            m_size = 0;
+            entries = allocate_entries(new_cap);
+            capacity = new_cap;
 
             for (uint32_t i = 0; i < old_cap; i++) {
                 if (old_entries[i].state == 1) {
-                    operator[](std::move(old_entries[i].data.first)) = 
-                        std::move(old_entries[i].data.second);
+                    size_t probes;
+                    size_t index = probe_slot(old_entries[i].data.first, m_hash(old_entries[i].data.first), probes);
+                    relocate(entries[index], old_entries[i]);
                 }
             }
 
-            delete[] old_entries;
+            free_entries(old_entries);
         }
 
     public:
         map() noexcept : capacity(InitialSize), m_size(0) {
-            entries = new Entry[capacity]();
+            entries = allocate_entries(capacity);
+        }
+
+        explicit map(const load_policy& policy) : map() {
+            set_load_policy(policy);
         }
 
         ~map() noexcept {
-            delete[] entries;
+            free_entries(entries);
         }
 
         map(map&& other) noexcept 
             : entries(other.entries)
             , capacity(other.capacity)
-            , m_size(other.m_size) {
+            , m_size(other.m_size)
+            , m_hash(std::move(other.m_hash))
+            , m_policy(other.m_policy)
+            , m_adaptive(other.m_adaptive)
+            , m_load_limit(other.m_load_limit)
+            , m_stats(other.m_stats)
+            , m_window(other.m_window) {
             other.entries = nullptr;
             other.capacity = 0;
             other.m_size = 0;
@@ -171,10 +540,16 @@ namespace shared {
 
         map& operator=(map&& other) noexcept {
             if (this != &other) {
-                delete[] entries;
+                free_entries(entries);
                 entries = other.entries;
                 capacity = other.capacity;
                 m_size = other.m_size;
+                m_hash = std::move(other.m_hash);
+                m_policy = other.m_policy;
+                m_adaptive = other.m_adaptive;
+                m_load_limit = other.m_load_limit;
+                m_stats = other.m_stats;
+                m_window = other.m_window;
                 other.entries = nullptr;
                 other.capacity = 0;
                 other.m_size = 0;
@@ -188,7 +563,7 @@ namespace shared {
          * @return Reference to value associated with key
          */
         v& operator[](const k& key) {
-            if (static_cast<float>(m_size + 1) / capacity > max_load_factor) {
+            if (over_limit(m_size + 1)) {
                 grow();
             }
 
@@ -220,18 +595,331 @@ namespace shared {
             return nullptr;
         }
 
+        /**
+         * @brief Hash of key as used by this table
+         * Indexing uses the low bits, so derive shard or filter indices from the high bits
+         * of a well-mixed hasher (wy_hasher, murmur_hasher). The default hash_fn (djb2)
+         * leaves its high bits zero or skewed for integers and short strings; mix its hash
+         * first (hashes::fmix64) before taking bits from it
+         */
+        size_t hash_of(const k& key) const noexcept {
+            return m_hash(key);
+        }
+
+        /**
+         * @brief find() with a precomputed hash
+         * @param hash Must equal hash_of(key)
+         */
+        const v* find_hashed(const k& key, size_t hash) const noexcept {
+            size_t index = find_slot_hashed(key, hash);
+            if (entries[index].state == 1 && entries[index].data.first == key) {
+                return &entries[index].data.second;
+            }
+            return nullptr;
+        }
+
+        v* find_hashed(const k& key, size_t hash) noexcept {
+            size_t index = find_slot_hashed(key, hash);
+            if (entries[index].state == 1 && entries[index].data.first == key) {
+                return &entries[index].data.second;
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Inserts key with a value constructed from args unless key is present
+         * The table only grows when a new entry is inserted
+         * @param hash Must equal hash_of(key)
+         * @return Pointer to the key's value and whether it was inserted
+         */
+        template <typename... Args>
+        pair<v*, bool> try_emplace_hashed(const k& key, size_t hash, Args&&... args) {
+            size_t index = find_slot_hashed(key, hash);
+            if (entries[index].state == 1) {
+                return pair<v*, bool>(&entries[index].data.second, false);
+            }
+            if (over_limit(m_size + 1)) {
+                grow();
+                size_t probes;
+                index = probe_slot(key, hash, probes);   // Already sampled above
+            }
+            entries[index].insert(key, v(std::forward<Args>(args)...));
+            m_size++;
+            return pair<v*, bool>(&entries[index].data.second, true);
+        }
+
+        template <typename... Args>
+        pair<v*, bool> try_emplace(const k& key, Args&&... args) {
+            return try_emplace_hashed(key, m_hash(key), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Inserts init if key is absent, otherwise applies update_fn to the stored value
+         * Unlike operator[], a hit never grows the table and the key is probed once
+         * @return Reference to the key's value
+         */
+        template <typename V, typename F>
+        v& upsert(const k& key, V&& init, F&& update_fn) {
+            auto result = try_emplace(key, std::forward<V>(init));
+            if (!result.second) {
+                update_fn(*result.first);
+            }
+            return *result.first;
+        }
+
+        /**
+         * @brief Applies fn to the value stored for key, if any
+         * @return Whether key was present
+         */
+        template <typename F>
+        bool update(const k& key, F&& fn) {
+            v* value = find(key);
+            if (value) {
+                fn(*value);
+            }
+            return value != nullptr;
+        }
+
+        /**
+         * @brief Probe-chain state machine for interleaved_lookup (see amac.hpp)
+         * Mirrors find_slot one probe per step, so G lookups overlap their misses
+         */
+        class lookup_machine {
+        private:
+            const map* m;
+
+        public:
+            using key_type = k;
+            using result_type = const v*;
+
+            struct state {
+                size_t index;
+                size_t i;
+                const k* key;
+            };
+
+            explicit lookup_machine(const map& owner) noexcept : m(&owner) {}
+
+            const void* init(state& s, const k& key) const noexcept {
+                s.key = &key;
+                s.index = m->m_hash(key) & (m->capacity - 1);
+                s.i = 0;
+                return &m->entries[s.index];
+            }
+
+            const void* step(state& s) const noexcept {
+                const Entry& e = m->entries[s.index];
+                if (e.state != 1 || e.data.first == *s.key) {
+                    return nullptr;
+                }
+                s.index = (s.index + s.i++) & (m->capacity - 1);
+                return &m->entries[s.index];
+            }
+
+            result_type result(const state& s) const noexcept {
+                const Entry& e = m->entries[s.index];
+                return (e.state == 1 && e.data.first == *s.key) ? &e.data.second : nullptr;
+            }
+        };
+
+        /**
+         * @brief Looks up n keys with `group` probe chains in flight
+         * @param results results[i] receives find(keys[i])
+         */
+        void find_batch(const k* keys, size_t n, const v** results, size_t group = 8) const {
+            interleaved_lookup(lookup_machine(*this), keys, n, group,
+                [results](size_t i, const v* value) { results[i] = value; });
+        }
+
         /**
          * @brief Removes all elements and resets to initial capacity
          */
         void clear() noexcept {
-            delete[] entries;
+            free_entries(entries);
             capacity = InitialSize;
-            entries = new Entry[capacity]();
+            entries = allocate_entries(capacity);
             m_size = 0;
         }
 
+        /**
+         * @brief Moves other's elements into this map, leaving other empty; keys already
+         * present keep this map's value
+         * The table is sized once for the union (overlap estimated from ~1K sampled keys
+         * of other), then each element is hashed once and relocated straight into its slot
+         * @return Number of elements inserted
+         */
+        size_t merge(map&& other) {
+            return merge(std::move(other), [](v&, v&&) {});
+        }
+
+        /**
+         * @brief merge() that resolves a duplicate key with combine(mine, std::move(theirs))
+         * If combine throws, both maps stay valid and other keeps the elements not yet merged
+         */
+        template <typename Combine>
+        size_t merge(map&& other, Combine&& combine) {
+            if (&other == this) {
+                return 0;
+            }
+            reserve(merged_size_estimate(other));
+            size_t inserted = 0;
+            other.for_each_occupied([&](uint32_t i) {
+                Entry& from = other.entries[i];
+                const size_t hash = m_hash(from.data.first);
+                size_t probes;
+                size_t index = probe_slot(from.data.first, hash, probes);
+                if (entries[index].state != 1 && over_limit(m_size + 1)) {
+                    grow();
+                    index = probe_slot(from.data.first, hash, probes);
+                }
+                if (entries[index].state == 1) {
+                    combine(entries[index].data.second, std::move(from.data.second));
+                } else {
+                    relocate(entries[index], from);
+                    m_size++;
+                    inserted++;
+                }
+                from.state = 0;
+                other.m_size--;
+            });
+            other.clear();
+            return inserted;
+        }
+
+        /**
+         * @brief Keeps only keys that are also in other (whose value type may differ)
+         * other is probed with this map's hash when both use the same stateless hasher
+         * @return Number of elements removed
+         */
+        template <typename V2, size_t I2, typename H2>
+        size_t intersect(const map<k, V2, I2, H2>& other) {
+            return filter([&other](const k& key, v&, size_t hash) { return contains_in(other, key, hash); });
+        }
+
+        /**
+         * @brief Removes keys that are in other (whose value type may differ)
+         * @return Number of elements removed
+         */
+        template <typename V2, size_t I2, typename H2>
+        size_t subtract(const map<k, V2, I2, H2>& other) {
+            return filter([&other](const k& key, v&, size_t hash) { return !contains_in(other, key, hash); });
+        }
+
+        /**
+         * @brief Keeps the elements for which pred(key, value) is true
+         * @return Number of elements removed
+         */
+        template <typename Pred>
+        size_t retain_if(Pred&& pred) {
+            return filter([&pred](const k& key, v& value, size_t) { return pred(key, value); });
+        }
+
+        /**
+         * @brief Deep copy with the same capacity, hash functor and load policy
+         * One memcpy of the slot array when k and v are trivially copyable, otherwise
+         * each element is copied into the same slot (requires copyable k and v)
+         */
+        map clone() const {
+            map copy(m_policy);
+            Entry* slots = allocate_entries(capacity, !trivial_entries);
+            free_entries(copy.entries);
+            copy.entries = slots;
+            copy.capacity = capacity;
+            copy.m_size = m_size;
+            copy.m_hash = m_hash;
+            copy.m_load_limit = m_load_limit;
+            if constexpr (trivial_entries) {
+                std::memcpy(static_cast<void*>(copy.entries), entries, sizeof(Entry) * capacity);
+            } else {
+                for (uint32_t i = 0; i < capacity; i++) {
+                    if (entries[i].state == 1) {
+                        copy.entries[i].insert(entries[i].data.first, entries[i].data.second);
+                    }
+                }
+            }
+            return copy;
+        }
+
+        /**
+         * @brief Number of slots find_slot inspects before settling on key's slot
+         * Diagnostic for measuring hash quality; 1 means the home slot was used
+         */
+        size_t probe_length(const k& key) const noexcept {
+            size_t index = m_hash(key) & (capacity - 1);
+            for (size_t i = 0; ; i++) {
+                if (entries[index].state != 1 || entries[index].data.first == key) {
+                    return i + 1;
+                }
+                index = (index + i) & (capacity - 1);
+            }
+        }
+
         size_t size() const noexcept { return m_size; }
         bool empty() const noexcept { return m_size == 0; }
+        size_t bucket_count() const noexcept { return capacity; }
+        float load_factor() const noexcept { return static_cast<float>(m_size) / capacity; }
+        size_t memory_bytes() const noexcept { return sizeof(Entry) * capacity; }
+
+        /**
+         * @brief Current growth threshold (moves within the policy bounds when adaptive)
+         */
+        float max_load_factor() const noexcept { return m_load_limit; }
+
+        /**
+         * @brief Fixes the growth threshold at lf, turning off adaptive tuning
+         */
+        void max_load_factor(float lf) {
+            load_policy policy = m_policy;
+            policy.min_load = policy.max_load = lf;
+            set_load_policy(policy);
+        }
+
+        /**
+         * @brief Replaces the load policy; throws std::invalid_argument unless
+         * 0 < min_load <= max_load < 1, target_probes >= 1 and window > 0
+         * The table is not rehashed; a lower limit applies from the next insertion
+         */
+        void set_load_policy(const load_policy& policy) {
+            if (!(policy.min_load > 0.0f && policy.min_load <= policy.max_load && policy.max_load < 1.0f) ||
+                !(policy.target_probes >= 1.0f) || policy.window == 0) {
+                throw std::invalid_argument("map: invalid load_policy");
+            }
+            m_policy = policy;
+            m_adaptive = policy.adaptive();
+            m_load_limit = policy.max_load;
+            reset_stats();
+        }
+
+        const load_policy& policy() const noexcept { return m_policy; }
+
+        /**
+         * @brief Sampled probe counters since the last reset (only collected when adaptive)
+         */
+        probe_stats stats() const noexcept {
+            probe_stats total = m_stats;
+            total.lookups += m_window.lookups;
+            total.probes += m_window.probes;
+            total.misses += m_window.misses;
+            return total;
+        }
+
+        void reset_stats() noexcept {
+            m_stats = probe_stats();
+            m_window = probe_stats();
+        }
+
+        /**
+         * @brief Grows the table so n elements fit under the current load limit
+         */
+        void reserve(size_t n) {
+            uint32_t new_cap = capacity;
+            while (static_cast<float>(n) / new_cap > m_load_limit) {
+                new_cap *= 2;
+            }
+            if (new_cap != capacity) {
+                rehash(new_cap);
+            }
+        }
 
         // Prevent copying to enforce move semantics
         map(const map&) = delete;
@@ -280,5 +968,59 @@ namespace shared {
         iterator end() noexcept {
             return iterator(entries, capacity, capacity);
         }
+
+        /**
+         * @brief Disjoint run of slots [first_slot, last_slot) from ranges()
+         * Iterates like the map (begin/end over its occupied slots); for_each scans with
+         * the occupancy bitmask and prefetches ahead. Invalidated by any insertion that
+         * rehashes and by merge/intersect/subtract/retain_if
+         */
+        class range {
+        private:
+            map* m_map;
+            uint32_t m_first;
+            uint32_t m_last;
+
+        public:
+            range(map* m, uint32_t first, uint32_t last) noexcept : m_map(m), m_first(first), m_last(last) {}
+
+            // The iterator stops at its capacity argument, so last bounds the walk
+            iterator begin() noexcept { return iterator(m_map->entries, m_last, m_first); }
+            iterator end() noexcept { return iterator(m_map->entries, m_last, m_last); }
+
+            uint32_t first_slot() const noexcept { return m_first; }
+            uint32_t last_slot() const noexcept { return m_last; }
+
+            /**
+             * @brief Calls fn(element) for each element in the range (element is pair<k, v>&)
+             */
+            template <typename F>
+            void for_each(F&& fn) const {
+                Entry* e = m_map->entries;
+                m_map->for_each_occupied([&](uint32_t i) { fn(e[i].data); }, m_first, m_last, true);
+            }
+        };
+
+        /**
+         * @brief Splits the slot array into n disjoint ranges covering it in order
+         * Boundaries fall on 64-slot blocks, so ranges never share a bitmask block and
+         * rarely a cache line; with fewer blocks than n the trailing ranges are empty.
+         * Ranges hold slot indices, not elements: sizes follow slot counts, which track
+         * element counts for a well-mixed hash
+         */
+        std::vector<range> ranges(size_t n) {
+            std::vector<range> parts;
+            if (n == 0) {
+                return parts;
+            }
+            parts.reserve(n);
+            const uint64_t blocks = (static_cast<uint64_t>(capacity) + 63) / 64;
+            for (size_t i = 0; i < n; i++) {
+                const uint64_t first = std::min<uint64_t>(blocks * i / n * 64, capacity);
+                const uint64_t last = std::min<uint64_t>(blocks * (i + 1) / n * 64, capacity);
+                parts.emplace_back(this, static_cast<uint32_t>(first), static_cast<uint32_t>(last));
+            }
+            return parts;
+        }
     };
 }
\ No newline at end of file
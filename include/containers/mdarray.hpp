@@ -0,0 +1,371 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "vector.hpp"
+
+/**
+ * @brief Two-dimensional views and arrays over flat storage with a layout policy
+ * (a 2D take on std::mdspan / std::mdarray for C++17)
+ *
+ * Layouts map (row, col) to an offset in the storage:
+ * - layout_right: row-major, r * cols + c (the flat shared::vector grids already use)
+ * - layout_left: column-major, c * rows + r
+ * - layout_tiled<TR, TC>: TR x TC tiles stored contiguously, tiles and the elements
+ *   inside a tile row-major. A tile (16 x 16 floats = 1 KB by default) is a run of
+ *   whole cache lines, so row and column passes both use every line they load.
+ *   Extents are padded up to whole tiles
+ *
+ * mdview is a non-owning (pointer, mapping) pair, cheap to copy and pass by value;
+ * mdarray owns a shared::vector sized to the mapping's span. for_each visits elements
+ * in storage order, the fastest pass under any layout.
+ *
+ * transpose(src, dst) is cache-oblivious: it halves the longer side of the block
+ * until both sides are at most transpose_leaf, so every level of the cache hierarchy
+ * sees blocks that fit, without tuning to a cache size. Source and destination may use
+ * different layouts (a transpose into the other major order is a layout conversion).
+ * Leaves whose blocks are strided in both layouts (always for row/column-major, inside
+ * one tile for tiled) run a pointer loop that stores along the destination's
+ * contiguous side; other leaves go through the mapping per element.
+ *
+ * Limitations:
+ * - Rank 2 only; no strided or sub-views (a subview of a tiled layout is not tiled)
+ * - Tile sides must be powers of two
+ * - Element access is unchecked; mdarray size mismatches throw std::invalid_argument
+ */
+
+namespace shared {
+    /**
+     * @brief Row-major layout: consecutive columns are adjacent
+     */
+    struct layout_right {
+        struct mapping {
+            size_t rows;
+            size_t cols;
+
+            mapping(size_t r, size_t c) noexcept : rows(r), cols(c) {}
+
+            size_t operator()(size_t r, size_t c) const noexcept { return r * cols + c; }
+            size_t required_span_size() const noexcept { return rows * cols; }
+
+            /**
+             * @brief Offset steps per row and per column inside block [r0, r1) x [c0, c1);
+             * false if offsets in the block are not affine in (r, c)
+             */
+            bool block_strides(size_t, size_t, size_t, size_t, size_t& row_step, size_t& col_step) const noexcept {
+                row_step = cols;
+                col_step = 1;
+                return true;
+            }
+
+            /**
+             * @brief Calls fn(r, c, offset) for every element in storage order
+             */
+            template <typename F>
+            void for_each_index(F&& fn) const {
+                for (size_t r = 0; r < rows; r++) {
+                    for (size_t c = 0; c < cols; c++) fn(r, c, r * cols + c);
+                }
+            }
+        };
+    };
+
+    /**
+     * @brief Column-major layout: consecutive rows are adjacent
+     */
+    struct layout_left {
+        struct mapping {
+            size_t rows;
+            size_t cols;
+
+            mapping(size_t r, size_t c) noexcept : rows(r), cols(c) {}
+
+            size_t operator()(size_t r, size_t c) const noexcept { return c * rows + r; }
+            size_t required_span_size() const noexcept { return rows * cols; }
+
+            bool block_strides(size_t, size_t, size_t, size_t, size_t& row_step, size_t& col_step) const noexcept {
+                row_step = 1;
+                col_step = rows;
+                return true;
+            }
+
+            template <typename F>
+            void for_each_index(F&& fn) const {
+                for (size_t c = 0; c < cols; c++) {
+                    for (size_t r = 0; r < rows; r++) fn(r, c, c * rows + r);
+                }
+            }
+        };
+    };
+
+    /**
+     * @brief Blocked layout of TileRows x TileCols tiles, row-major at both levels
+     * @tparam TileRows Rows per tile (power of two)
+     * @tparam TileCols Columns per tile (power of two)
+     */
+    template <size_t TileRows = 16, size_t TileCols = 16>
+    struct layout_tiled {
+        static_assert(TileRows > 0 && (TileRows & (TileRows - 1)) == 0, "TileRows must be a power of two");
+        static_assert(TileCols > 0 && (TileCols & (TileCols - 1)) == 0, "TileCols must be a power of two");
+
+        struct mapping {
+            static constexpr size_t tile_rows = TileRows;
+            static constexpr size_t tile_cols = TileCols;
+            static constexpr size_t tile_size = TileRows * TileCols;
+
+            size_t rows;
+            size_t cols;
+            size_t tiles_per_row;   // Tiles across the padded width
+
+            mapping(size_t r, size_t c) noexcept
+                : rows(r), cols(c), tiles_per_row((c + TileCols - 1) / TileCols) {}
+
+            size_t operator()(size_t r, size_t c) const noexcept {
+                return ((r / TileRows) * tiles_per_row + c / TileCols) * tile_size
+                     + (r % TileRows) * TileCols + c % TileCols;
+            }
+
+            size_t required_span_size() const noexcept {
+                return (rows + TileRows - 1) / TileRows * tiles_per_row * tile_size;
+            }
+
+            /**
+             * @brief Affine only for a block inside one tile
+             */
+            bool block_strides(size_t r0, size_t c0, size_t r1, size_t c1, size_t& row_step, size_t& col_step) const noexcept {
+                row_step = TileCols;
+                col_step = 1;
+                return r0 / TileRows == (r1 - 1) / TileRows && c0 / TileCols == (c1 - 1) / TileCols;
+            }
+
+            /**
+             * @brief Calls fn(r, c, offset) tile by tile, skipping the padding
+             */
+            template <typename F>
+            void for_each_index(F&& fn) const {
+                for (size_t r0 = 0; r0 < rows; r0 += TileRows) {
+                    const size_t r1 = std::min(r0 + TileRows, rows);
+                    for (size_t c0 = 0; c0 < cols; c0 += TileCols) {
+                        const size_t c1 = std::min(c0 + TileCols, cols);
+                        const size_t base = (*this)(r0, c0);
+                        for (size_t r = r0; r < r1; r++) {
+                            const size_t line = base + (r - r0) * TileCols;
+                            for (size_t c = c0; c < c1; c++) fn(r, c, line + (c - c0));
+                        }
+                    }
+                }
+            }
+        };
+    };
+
+    /**
+     * @brief Non-owning 2D view of data under Layout
+     * @tparam T Element type; const T for a read-only view
+     */
+    template <class T, class Layout = layout_right>
+    class mdview {
+    public:
+        using element_type = T;
+        using layout_type = Layout;
+        using mapping_type = typename Layout::mapping;
+
+    private:
+        T* _data;
+        mapping_type _map;
+
+    public:
+        mdview(T* data, size_t rows, size_t cols) noexcept : _data(data), _map(rows, cols) {}
+        mdview(T* data, const mapping_type& map) noexcept : _data(data), _map(map) {}
+
+        /**
+         * @brief Read-only view of a mutable one
+         */
+        template <class U, typename = std::enable_if_t<std::is_same_v<T, const U>>>
+        mdview(const mdview<U, Layout>& other) noexcept : _data(other.data()), _map(other.mapping()) {}
+
+        size_t rows() const noexcept { return _map.rows; }
+        size_t cols() const noexcept { return _map.cols; }
+        size_t size() const noexcept { return _map.rows * _map.cols; }
+        T* data() const noexcept { return _data; }
+        const mapping_type& mapping() const noexcept { return _map; }
+
+        T& operator()(size_t r, size_t c) const noexcept { return _data[_map(r, c)]; }
+
+        /**
+         * @brief Calls fn(element) for every element in storage order
+         */
+        template <typename F>
+        void for_each(F&& fn) const {
+            _map.for_each_index([&](size_t, size_t, size_t offset) { fn(_data[offset]); });
+        }
+
+        /**
+         * @brief Calls fn(r, c, element) for every element in storage order
+         */
+        template <typename F>
+        void for_each_indexed(F&& fn) const {
+            _map.for_each_index([&](size_t r, size_t c, size_t offset) { fn(r, c, _data[offset]); });
+        }
+    };
+
+    /**
+     * @brief 2D array owning its elements in a shared::vector laid out by Layout
+     */
+    template <class T, class Layout = layout_right>
+    class mdarray {
+    public:
+        using layout_type = Layout;
+        using mapping_type = typename Layout::mapping;
+
+    private:
+        mapping_type _map;
+        vector<T> _elements;   // required_span_size() elements, padding included
+
+    public:
+        mdarray(size_t rows, size_t cols, const T& val = T()) : _map(rows, cols) {
+            _elements.assign(_map.required_span_size(), val);
+        }
+
+        /**
+         * @brief Array whose storage is allocated with the given page-level options
+         */
+        mdarray(size_t rows, size_t cols, const alloc_options& options, const T& val = T())
+            : _map(rows, cols), _elements(options) {
+            _elements.assign(_map.required_span_size(), val);
+        }
+
+        /**
+         * @brief Takes over elements already laid out by Layout (e.g. a flat row-major grid)
+         * @throws std::invalid_argument if elements.size() is not the mapping's span
+         */
+        mdarray(vector<T>&& elements, size_t rows, size_t cols) : _map(rows, cols) {
+            if (elements.size() != _map.required_span_size()) {
+                throw std::invalid_argument("mdarray: storage size does not match extents");
+            }
+            _elements = std::move(elements);
+        }
+
+        size_t rows() const noexcept { return _map.rows; }
+        size_t cols() const noexcept { return _map.cols; }
+        size_t size() const noexcept { return _map.rows * _map.cols; }
+        T* data() noexcept { return _elements.data(); }
+        const T* data() const noexcept { return _elements.data(); }
+        const mapping_type& mapping() const noexcept { return _map; }
+
+        /**
+         * @brief The underlying storage, including tile padding
+         */
+        const vector<T>& storage() const noexcept { return _elements; }
+
+        /**
+         * @brief Moves the storage out, leaving an empty 0 x 0 array
+         */
+        vector<T> release() {
+            _map = mapping_type(0, 0);
+            return std::move(_elements);
+        }
+
+        T& operator()(size_t r, size_t c) noexcept { return _elements[_map(r, c)]; }
+        const T& operator()(size_t r, size_t c) const noexcept { return _elements[_map(r, c)]; }
+
+        mdview<T, Layout> view() noexcept { return mdview<T, Layout>(_elements.data(), _map); }
+        mdview<const T, Layout> view() const noexcept { return mdview<const T, Layout>(_elements.data(), _map); }
+
+        template <typename F>
+        void for_each(F&& fn) { view().for_each(std::forward<F>(fn)); }
+
+        template <typename F>
+        void for_each(F&& fn) const { view().for_each(std::forward<F>(fn)); }
+    };
+
+    /**
+     * @brief Side length at which transpose stops splitting: 16 x 16 source and
+     * destination blocks (2 KB of floats) stay in L1 while the leaf loop runs
+     */
+    inline constexpr size_t transpose_leaf = 16;
+
+    namespace detail {
+        template <class S, class D>
+        void transpose_leaf_block(const S& src, const D& dst, size_t r0, size_t r1, size_t c0, size_t c1) {
+            size_t s_row, s_col, d_row, d_col;
+            if (!src.mapping().block_strides(r0, c0, r1, c1, s_row, s_col) ||
+                !dst.mapping().block_strides(c0, r0, c1, r1, d_row, d_col)) {
+                for (size_t r = r0; r < r1; r++) {
+                    for (size_t c = c0; c < c1; c++) dst(c, r) = src(r, c);
+                }
+                return;
+            }
+            // Both blocks are strided: index from the block corners, and keep the inner
+            // loop on dst's contiguous side when it has one (strided stores cost more
+            // than strided loads)
+            const auto* s = src.data() + src.mapping()(r0, c0);
+            auto* d = dst.data() + dst.mapping()(c0, r0);
+            const size_t nr = r1 - r0;
+            const size_t nc = c1 - c0;
+            if (d_col == 1) {
+                for (size_t c = 0; c < nc; c++) {
+                    for (size_t r = 0; r < nr; r++) d[c * d_row + r] = s[r * s_row + c * s_col];
+                }
+            } else {
+                for (size_t r = 0; r < nr; r++) {
+                    for (size_t c = 0; c < nc; c++) d[c * d_row + r * d_col] = s[r * s_row + c * s_col];
+                }
+            }
+        }
+
+        template <class S, class D>
+        void transpose_block(const S& src, const D& dst, size_t r0, size_t r1, size_t c0, size_t c1) {
+            for (;;) {
+                const size_t nr = r1 - r0;
+                const size_t nc = c1 - c0;
+                if (nr <= transpose_leaf && nc <= transpose_leaf) {
+                    transpose_leaf_block(src, dst, r0, r1, c0, c1);
+                    return;
+                }
+                // Split the longer side at a multiple of the leaf, so leaves line up with
+                // 64-byte lines and default tiles; recurse on one half, loop on the other
+                if (nr >= nc) {
+                    const size_t mid = r0 + std::max(transpose_leaf, nr / 2 / transpose_leaf * transpose_leaf);
+                    transpose_block(src, dst, r0, mid, c0, c1);
+                    r0 = mid;
+                } else {
+                    const size_t mid = c0 + std::max(transpose_leaf, nc / 2 / transpose_leaf * transpose_leaf);
+                    transpose_block(src, dst, r0, r1, c0, mid);
+                    c0 = mid;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief dst(c, r) = src(r, c) for the whole of src, cache-obliviously
+     * src and dst must not overlap
+     * @throws std::invalid_argument if dst is not src.cols() x src.rows()
+     */
+    template <class S, class LS, class D, class LD>
+    void transpose(const mdview<S, LS>& src, const mdview<D, LD>& dst) {
+        if (dst.rows() != src.cols() || dst.cols() != src.rows()) {
+            throw std::invalid_argument("transpose: destination extents must be the source's swapped");
+        }
+        if (src.rows() == 0 || src.cols() == 0) return;
+        detail::transpose_block(src, dst, 0, src.rows(), 0, src.cols());
+    }
+
+    template <class T, class LS, class LD>
+    void transpose(const mdarray<T, LS>& src, mdarray<T, LD>& dst) {
+        transpose(src.view(), dst.view());
+    }
+
+    /**
+     * @brief New array holding the transpose of src, under layout LD (src's by default)
+     */
+    template <class LD = void, class T, class LS>
+    auto transposed(const mdarray<T, LS>& src) {
+        using L = std::conditional_t<std::is_void_v<LD>, LS, LD>;
+        mdarray<T, L> dst(src.cols(), src.rows());
+        transpose(src.view(), dst.view());
+        return dst;
+    }
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief NUMA topology discovery and page placement helpers (Linux)
+ *
+ * - Topology comes from /sys/devices/system/node (online nodes and their cpulists);
+ *   systems without it, and non-Linux builds, report a single node with every CPU
+ * - Memory policies are applied with the raw mbind syscall, so libnuma is not needed
+ * - Threads are pinned with pthread_setaffinity_np
+ *
+ * A single-socket machine can be tested with a fake topology (numa=fake=2 on the
+ * kernel command line); all helpers degrade to no-ops on one node.
+ */
+
+namespace shared {
+    /**
+     * @brief Where the pages of a parallel-constructed container land
+     * - serial:      the calling thread constructs everything (all pages on its node)
+     * - first_touch: each pool worker constructs its own page-aligned chunk, so the
+     *                chunk lands on the worker's node; scan with the same chunking
+     * - interleave:  pages are spread round-robin over all nodes (MPOL_INTERLEAVE),
+     *                then constructed in parallel; uniform bandwidth for any access pattern
+     */
+    enum class numa_placement { serial, first_touch, interleave };
+
+    namespace numa {
+        struct node {
+            int id;
+            std::vector<int> cpus;
+        };
+
+        /**
+         * @brief Parses a kernel cpulist/nodelist such as "0-3,8,10-11"
+         */
+        inline std::vector<int> parse_list(const std::string& text) {
+            std::vector<int> out;
+            size_t pos = 0;
+            while (pos < text.size()) {
+                size_t end = text.find(',', pos);
+                if (end == std::string::npos) end = text.size();
+                const std::string item = text.substr(pos, end - pos);
+                const size_t dash = item.find('-');
+                try {
+                    if (dash == std::string::npos) {
+                        out.push_back(std::stoi(item));
+                    }
+                    else {
+                        const int lo = std::stoi(item.substr(0, dash));
+                        const int hi = std::stoi(item.substr(dash + 1));
+                        for (int i = lo; i <= hi; ++i) out.push_back(i);
+                    }
+                }
+                catch (const std::exception&) {
+                    // Trailing newline or empty list
+                }
+                pos = end + 1;
+            }
+            return out;
+        }
+
+        /**
+         * @brief Online nodes and their CPUs, read once
+         */
+        inline const std::vector<node>& topology() {
+            static const std::vector<node> nodes = [] {
+                std::vector<node> found;
+                std::ifstream online("/sys/devices/system/node/online");
+                std::string line;
+                if (online && std::getline(online, line)) {
+                    for (int id : parse_list(line)) {
+                        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+                        std::string cpus;
+                        std::getline(cpulist, cpus);
+                        found.push_back(node{id, parse_list(cpus)});
+                    }
+                }
+                if (found.empty()) {
+                    node all{0, {}};
+                    const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+                    for (unsigned i = 0; i < n; ++i) all.cpus.push_back(static_cast<int>(i));
+                    found.push_back(all);
+                }
+                return found;
+            }();
+            return nodes;
+        }
+
+        inline size_t node_count() { return topology().size(); }
+
+        /**
+         * @brief Restricts the calling thread to the CPUs of the index-th online node
+         * @return false if pinning is unsupported or failed
+         */
+        inline bool pin_current_thread(size_t index) {
+#if defined(__linux__)
+            const node& n = topology()[index % node_count()];
+            if (n.cpus.empty()) return false;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : n.cpus) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            }
+            return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#else
+            (void)index;
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Worker start hook for thread_pool: worker w is pinned to node w % node_count()
+         */
+        inline std::function<void(size_t)> spread_workers() {
+            return [](size_t worker) { pin_current_thread(worker); };
+        }
+
+        /**
+         * @brief System page size (sysconf; 4 KB where it is unavailable)
+         */
+        inline size_t page_size() noexcept {
+#if defined(__linux__)
+            static const size_t page = [] {
+                const long p = ::sysconf(_SC_PAGESIZE);
+                return p > 0 ? static_cast<size_t>(p) : size_t(4096);
+            }();
+            return page;
+#else
+            return 4096;
+#endif
+        }
+
+#if defined(__linux__) && defined(SYS_mbind)
+        namespace detail {
+            // From <linux/mempolicy.h>, spelled out to avoid depending on numaif.h
+            constexpr int mpol_bind = 2;
+            constexpr int mpol_interleave = 3;
+            constexpr size_t mask_words = 16;   // 1024 nodes
+
+            inline bool mbind(void* addr, size_t bytes, int mode, const std::vector<int>& ids) {
+                unsigned long mask[mask_words] = {};
+                for (int id : ids) {
+                    if (id >= 0 && static_cast<size_t>(id) < mask_words * 64) {
+                        mask[id / 64] |= 1ul << (id % 64);
+                    }
+                }
+                // mbind needs a page-aligned start; pages straddling the range keep their policy
+                const uintptr_t page = static_cast<uintptr_t>(page_size());
+                uintptr_t begin = (reinterpret_cast<uintptr_t>(addr) + page - 1) & ~(page - 1);
+                uintptr_t end = reinterpret_cast<uintptr_t>(addr) + bytes;
+                if (end <= begin) return true;
+                return ::syscall(SYS_mbind, begin, end - begin, mode, mask, mask_words * 64, 0) == 0;
+            }
+        }
+#endif
+
+        /**
+         * @brief Interleaves the not-yet-touched pages of [addr, addr + bytes) over all nodes
+         * Already faulted pages are not migrated. No-op (returns true) on a single node
+         */
+        inline bool interleave(void* addr, size_t bytes) {
+            if (node_count() < 2) return true;
+#if defined(__linux__) && defined(SYS_mbind)
+            std::vector<int> ids;
+            for (const node& n : topology()) ids.push_back(n.id);
+            return detail::mbind(addr, bytes, detail::mpol_interleave, ids);
+#else
+            (void)addr;
+            (void)bytes;
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Binds the not-yet-touched pages of [addr, addr + bytes) to the index-th online node
+         */
+        inline bool bind(void* addr, size_t bytes, size_t index) {
+            if (node_count() < 2) return true;
+#if defined(__linux__) && defined(SYS_mbind)
+            return detail::mbind(addr, bytes, detail::mpol_bind, {topology()[index % node_count()].id});
+#else
+            (void)addr;
+            (void)bytes;
+            (void)index;
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Element range [first, second) owned by worker out of workers for the n
+         * elements of elem_size bytes at data
+         * Boundaries are the first elements starting at or after a page boundary of the
+         * actual address (heap blocks rarely start on a page), so no page is shared by two
+         * workers' chunks unless an element straddles that boundary (elem_size not
+         * dividing the page offset). The partial page before the first boundary goes to
+         * worker 0
+         */
+        inline std::pair<size_t, size_t> page_chunk(const void* data, size_t n, size_t elem_size,
+                                                    size_t worker, size_t workers) {
+            elem_size = std::max<size_t>(1, elem_size);
+            const uintptr_t page = static_cast<uintptr_t>(page_size());
+            const uintptr_t base = reinterpret_cast<uintptr_t>(data);
+            const uintptr_t end = base + n * elem_size;
+            const uintptr_t aligned = (base + page - 1) & ~(page - 1);
+            if (end <= aligned) {
+                return worker == 0 ? std::pair<size_t, size_t>(0, n) : std::pair<size_t, size_t>(n, n);
+            }
+            const size_t pages = static_cast<size_t>((end - aligned + page - 1) / page);
+            // First element starting at or after page boundary k (k = 0 takes the lead-in)
+            auto boundary = [&](size_t k) -> size_t {
+                if (k == 0) return 0;
+                const uintptr_t at = aligned + k * page;
+                return std::min(n, static_cast<size_t>((at - base + elem_size - 1) / elem_size));
+            };
+            return {boundary(pages * worker / workers), boundary(pages * (worker + 1) / workers)};
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Page-level allocation options for large buffers (transparent huge pages, prefault)
+ *
+ * - huge_pages: the buffer is an anonymous mapping aligned to 2 MB and rounded up to
+ *   whole 2 MB pages, marked MADV_HUGEPAGE, so THP can back it with huge pages even in
+ *   "madvise" mode. One TLB entry then covers 512x more memory than with 4 KB pages
+ * - prefault: populate faults every page in at allocation time (MAP_POPULATE, or
+ *   MADV_POPULATE_WRITE/touching for huge pages so the populate happens after
+ *   MADV_HUGEPAGE), keeping page-fault storms out of later timed loops. willneed only
+ *   issues MADV_WILLNEED, an asynchronous hint that mostly matters for swapped pages
+ * - release_on_shrink: shrinking returns whole pages past the new end to the OS with
+ *   MADV_DONTNEED; the capacity (address range) is kept
+ *
+ * Default options allocate with ::operator new, exactly like before. Non-POSIX builds
+ * always do. Prefaulting on the allocating thread places every page on its NUMA node,
+ * so do not combine populate with first_touch placement.
+ */
+
+namespace shared {
+    enum class prefault_mode { none, populate, willneed };
+
+    struct alloc_options {
+        bool huge_pages = false;
+        prefault_mode prefault = prefault_mode::none;
+        bool release_on_shrink = false;
+
+        bool uses_mmap() const noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+            return huge_pages || prefault != prefault_mode::none || release_on_shrink;
+#else
+            return false;
+#endif
+        }
+    };
+
+    namespace pages {
+        static constexpr size_t huge_page_bytes = size_t(2) << 20;
+
+        inline size_t page_bytes() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+            static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return size;
+#else
+            return 4096;
+#endif
+        }
+
+        inline size_t mapping_bytes(size_t bytes, const alloc_options& options) noexcept {
+            const size_t unit = options.huge_pages ? huge_page_bytes : page_bytes();
+            return (std::max<size_t>(bytes, 1) + unit - 1) / unit * unit;
+        }
+
+        /**
+         * @brief Allocates bytes according to options; throws std::bad_alloc on failure
+         */
+        inline void* allocate(size_t bytes, const alloc_options& options) {
+            if (!options.uses_mmap()) return ::operator new(bytes);
+#if defined(__unix__) || defined(__APPLE__)
+            const size_t length = mapping_bytes(bytes, options);
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_POPULATE)
+            if (options.prefault == prefault_mode::populate && !options.huge_pages) flags |= MAP_POPULATE;
+#endif
+            // Over-map by one huge page and trim, so the start is 2 MB aligned
+            const size_t slack = options.huge_pages ? huge_page_bytes : 0;
+            void* raw = ::mmap(nullptr, length + slack, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+
+            char* base = static_cast<char*>(raw);
+            if (slack) {
+                const uintptr_t addr = reinterpret_cast<uintptr_t>(base);
+                char* aligned = base + ((huge_page_bytes - addr % huge_page_bytes) % huge_page_bytes);
+                if (aligned > base) ::munmap(base, static_cast<size_t>(aligned - base));
+                const size_t tail = static_cast<size_t>(base + length + slack - (aligned + length));
+                if (tail) ::munmap(aligned + length, tail);
+                base = aligned;
+#if defined(MADV_HUGEPAGE)
+                ::madvise(base, length, MADV_HUGEPAGE);
+#endif
+                if (options.prefault == prefault_mode::populate) {
+#if defined(MADV_POPULATE_WRITE)
+                    if (::madvise(base, length, MADV_POPULATE_WRITE) != 0)
+#endif
+                    {
+                        for (size_t off = 0; off < length; off += page_bytes()) {
+                            static_cast<volatile char*>(base)[off] = 0;
+                        }
+                    }
+                }
+            }
+            if (options.prefault == prefault_mode::willneed) {
+                ::madvise(base, length, MADV_WILLNEED);
+            }
+            return base;
+#else
+            return ::operator new(bytes);
+#endif
+        }
+
+        /**
+         * @brief Frees memory from allocate(); bytes and options must match the allocation
+         */
+        inline void deallocate(void* p, size_t bytes, const alloc_options& options) noexcept {
+            if (!p) return;
+            if (!options.uses_mmap()) {
+                ::operator delete(p);
+                return;
+            }
+#if defined(__unix__) || defined(__APPLE__)
+            ::munmap(p, mapping_bytes(bytes, options));
+#else
+            (void)bytes;
+            ::operator delete(p);
+#endif
+        }
+
+        /**
+         * @brief Returns the whole pages inside [p, p + bytes) to the OS; they read back as zero
+         */
+        inline void release(void* p, size_t bytes) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+            const uintptr_t page = page_bytes();
+            const uintptr_t begin = (reinterpret_cast<uintptr_t>(p) + page - 1) & ~(page - 1);
+            const uintptr_t end = (reinterpret_cast<uintptr_t>(p) + bytes) & ~(page - 1);
+            if (end > begin) ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#else
+            (void)p;
+            (void)bytes;
+#endif
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include "thread_pool.hpp"
+
+/**
+ * @brief Parallel scans over containers that split into ranges
+ *
+ * A container qualifies when ranges(n) returns n disjoint ranges whose for_each(fn)
+ * visits every element once (shared::map, shared::vector). Each range runs as one
+ * pool task and prefetches ahead of its own scan position.
+ *
+ * Reductions: fn sees one element at a time; to reduce, take ranges() directly,
+ * keep a local accumulator per range and combine the partials afterwards (see
+ * parallel_benchmarks.hpp).
+ *
+ * Limitations:
+ * - The container must not be modified structurally during the scan; fn may write
+ *   through the element it receives (values only, never map keys)
+ * - Ranges are split by position, not by work: a skewed map spreads unevenly,
+ *   which chunks_per_worker > 1 evens out through the shared task queue
+ */
+
+namespace shared {
+    /**
+     * @brief Calls fn(element) for every element of c on the pool's workers
+     * fn runs concurrently and must be safe to call from several threads at once.
+     * The first exception thrown by fn is rethrown after all ranges finished
+     * @param chunks_per_worker Ranges queued per worker; more balances uneven ranges
+     */
+    template <typename Container, typename F>
+    void parallel_for_each(Container& c, F&& fn, thread_pool& pool, size_t chunks_per_worker = 4) {
+        const size_t n = pool.size() * (chunks_per_worker ? chunks_per_worker : 1);
+        auto parts = c.ranges(n);
+        pool.parallel_for(parts.size(), [&](size_t i) { parts[i].for_each(fn); });
+    }
+}
@@ -0,0 +1,661 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Persistent (immutable, versioned) vector as a relaxed radix balanced tree
+ *
+ * Structure:
+ * - 32-wide nodes shared between versions through atomic reference counts; an
+ *   update copies only the root-to-leaf path (O(log32 n) nodes)
+ * - Tail optimization: the last leaf lives outside the tree, so push_back copies at
+ *   most 32 elements and touches the tree once per 32 pushes
+ * - Inner nodes keep cumulative size tables. Balanced nodes (every child but the last
+ *   full) are indexed by radix alone; relaxed ones, produced by concat and slice,
+ *   start from the radix guess and step forward through the size table
+ * - concat merges the right spine of one tree with the left spine of the other,
+ *   redistributing slots so each level keeps at most 2 more nodes than optimal
+ *   (Bagwell & Rompf's RRB concatenation), O(log n) nodes touched
+ * - slice copies the two cut paths
+ *
+ * In-place edits: a node whose reference count is 1 belongs to this version only and
+ * is modified without copying. transient() returns a builder whose nodes stay unshared
+ * while it edits, so batched push_back/set run without path copies; rvalue
+ * push_back/set (std::move(v).push_back(x)) do the same for a version nobody shares.
+ *
+ * Thread safety matches std::shared_ptr: versions that share nodes may be used from
+ * different threads; one object (or transient) needs external synchronization.
+ *
+ * Limitations:
+ * - T's copy constructor must not throw while a version is being built
+ * - No erase/insert in the middle (concat of slices composes them in O(log n))
+ */
+
+namespace shared {
+    template <class T>
+    class persistent_vector {
+    public:
+        static constexpr unsigned bits = 5;
+        static constexpr size_t width = size_t(1) << bits;
+
+    private:
+        static constexpr size_t mask = width - 1;
+        static constexpr size_t extra_slots = 2;  // Nodes per level allowed above optimal after concat
+
+        struct node {
+            std::atomic<uint32_t> refs;
+            uint32_t count;   // Children (inner) or elements (leaf)
+            const bool leaf;
+            bool relaxed;     // Inner only: radix indexing needs the size table
+
+            explicit node(bool is_leaf) noexcept : refs(1), count(0), leaf(is_leaf), relaxed(false) {}
+        };
+
+        struct leaf_node : node {
+            alignas(T) unsigned char storage[width * sizeof(T)];
+
+            leaf_node() noexcept : node(true) {}
+            T* values() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+            const T* values() const noexcept { return std::launder(reinterpret_cast<const T*>(storage)); }
+        };
+
+        struct inner_node : node {
+            node* children[width];
+            size_t sizes[width];  // sizes[i]: elements under children[0..i]
+
+            inner_node() noexcept : node(false) {}
+        };
+
+        node* _root;      // nullptr when every element is in the tail
+        node* _tail;      // Leaf holding the last elements; may be nullptr or empty
+        unsigned _shift;  // Root's child-index shift (0 when the root is a leaf)
+        size_t _size;
+
+        static leaf_node* as_leaf(node* n) noexcept { return static_cast<leaf_node*>(n); }
+        static const leaf_node* as_leaf(const node* n) noexcept { return static_cast<const leaf_node*>(n); }
+        static inner_node* as_inner(node* n) noexcept { return static_cast<inner_node*>(n); }
+        static const inner_node* as_inner(const node* n) noexcept { return static_cast<const inner_node*>(n); }
+
+        static void retain(const node* n) noexcept {
+            const_cast<node*>(n)->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void release(node* n) noexcept {
+            if (!n || n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            if (n->leaf) {
+                leaf_node* leaf = as_leaf(n);
+                for (uint32_t i = 0; i < leaf->count; i++) leaf->values()[i].~T();
+                delete leaf;
+            } else {
+                inner_node* inner = as_inner(n);
+                for (uint32_t i = 0; i < inner->count; i++) release(inner->children[i]);
+                delete inner;
+            }
+        }
+
+        static size_t size_of(const node* n) noexcept {
+            if (n->leaf) return n->count;
+            return as_inner(n)->sizes[n->count - 1];
+        }
+
+        static leaf_node* leaf_from(const T* first, size_t n) {
+            leaf_node* leaf = new leaf_node();
+            for (size_t i = 0; i < n; i++) new (leaf->values() + i) T(first[i]);
+            leaf->count = static_cast<uint32_t>(n);
+            return leaf;
+        }
+
+        static inner_node* clone_inner(const inner_node* src) {
+            inner_node* copy = new inner_node();
+            for (uint32_t i = 0; i < src->count; i++) {
+                retain(src->children[i]);
+                copy->children[i] = src->children[i];
+                copy->sizes[i] = src->sizes[i];
+            }
+            copy->count = src->count;
+            copy->relaxed = src->relaxed;
+            return copy;
+        }
+
+        /**
+         * @brief Recomputes sizes[first..count) and the relaxed flag of an inner node at shift
+         * A subtree holding exactly 1 << shift elements is necessarily packed, so the node
+         * is balanced iff its prefix is full by size and its last child is balanced
+         */
+        static void refresh(inner_node* n, unsigned shift, uint32_t first = 0) noexcept {
+            size_t total = first ? n->sizes[first - 1] : 0;
+            for (uint32_t i = first; i < n->count; i++) {
+                total += size_of(n->children[i]);
+                n->sizes[i] = total;
+            }
+            const uint32_t last = n->count - 1;
+            n->relaxed = n->children[last]->relaxed || (last > 0 && n->sizes[last - 1] != static_cast<size_t>(last) << shift);
+        }
+
+        /**
+         * @brief Child slot of an inner node at shift holding element i; i becomes the
+         * index within that child
+         */
+        static uint32_t child_slot(const inner_node* n, unsigned shift, size_t& i) noexcept {
+            uint32_t slot = static_cast<uint32_t>((i >> shift) & mask);
+            if (n->relaxed) {
+                while (n->sizes[slot] <= i) slot++;
+                if (slot) i -= n->sizes[slot - 1];
+            } else {
+                i &= (size_t(1) << shift) - 1;
+            }
+            return slot;
+        }
+
+        /**
+         * @brief Makes *slot exclusive to this version, copying it if shared
+         */
+        static node* own(node*& slot) {
+            if (slot->refs.load(std::memory_order_acquire) != 1) {
+                node* copy = slot->leaf ? static_cast<node*>(leaf_from(as_leaf(slot)->values(), slot->count))
+                                        : static_cast<node*>(clone_inner(as_inner(slot)));
+                release(slot);
+                slot = copy;
+            }
+            return slot;
+        }
+
+        /**
+         * @brief Whether some inner node on n's right spine has a free child slot
+         */
+        static bool has_room(const node* n) noexcept {
+            while (!n->leaf) {
+                if (n->count < width) return true;
+                n = as_inner(n)->children[n->count - 1];
+            }
+            return false;
+        }
+
+        /**
+         * @brief Chain of single-child inner nodes from shift down to leaf
+         */
+        static node* new_path(unsigned shift, node* leaf) {
+            if (shift == 0) return leaf;
+            inner_node* n = new inner_node();
+            n->children[0] = new_path(shift - bits, leaf);
+            n->count = 1;
+            refresh(n, shift);
+            return n;
+        }
+
+        /**
+         * @brief Appends leaf as the rightmost leaf under *slot; requires has_room(*slot)
+         */
+        static void push_into(node*& slot, unsigned shift, node* leaf) {
+            inner_node* n = as_inner(own(slot));
+            const uint32_t last = n->count - 1;
+            if (shift > bits && has_room(n->children[last])) {
+                push_into(n->children[last], shift - bits, leaf);
+                refresh(n, shift, last);
+            } else {
+                n->children[n->count++] = new_path(shift - bits, leaf);
+                refresh(n, shift, last);
+            }
+        }
+
+        /**
+         * @brief Moves the reference to leaf into the tree as its last leaf
+         */
+        void push_tail(node* leaf) {
+            if (leaf->count == 0) {
+                release(leaf);
+                return;
+            }
+            if (!_root) {
+                _root = leaf;
+                _shift = 0;
+                return;
+            }
+            if (has_room(_root)) {
+                push_into(_root, _shift, leaf);
+                return;
+            }
+            inner_node* root = new inner_node();
+            root->children[0] = _root;
+            root->children[1] = new_path(_shift, leaf);
+            root->count = 2;
+            _shift += bits;
+            refresh(root, _shift);
+            _root = root;
+        }
+
+        static void collapse(node*& root, unsigned& shift) noexcept {
+            while (root && !root->leaf && root->count == 1) {
+                node* child = as_inner(root)->children[0];
+                retain(child);
+                release(root);
+                root = child;
+                shift -= bits;
+            }
+        }
+
+        size_t tail_count() const noexcept { return _tail ? _tail->count : 0; }
+
+        void append(T value) {
+            if (!_tail) {
+                _tail = new leaf_node();
+            } else if (_tail->count == width) {
+                push_tail(_tail);
+                _tail = new leaf_node();
+            } else {
+                own(_tail);
+            }
+            leaf_node* tail = as_leaf(_tail);
+            new (tail->values() + tail->count) T(std::move(value));
+            tail->count++;
+            _size++;
+        }
+
+        void assign_at(size_t i, T value) {
+            const size_t tail_start = _size - tail_count();
+            if (i >= tail_start) {
+                as_leaf(own(_tail))->values()[i - tail_start] = std::move(value);
+                return;
+            }
+            node** slot = &_root;
+            unsigned shift = _shift;
+            while (!(*slot)->leaf) {
+                inner_node* n = as_inner(own(*slot));
+                slot = &n->children[child_slot(n, shift, i)];
+                shift -= bits;
+            }
+            as_leaf(own(*slot))->values()[i] = std::move(value);
+        }
+
+        // Concatenation (Bagwell & Rompf; L'orange's search-step invariant)
+
+        /**
+         * @brief Concatenates the trees under l (at ls) and r (at rs)
+         * @return New inner node at max(ls, rs) + bits with one or two children
+         */
+        static inner_node* concat_sub(const node* l, unsigned ls, const node* r, unsigned rs) {
+            if (ls > rs) {
+                const inner_node* left = as_inner(l);
+                inner_node* centre = concat_sub(left->children[left->count - 1], ls - bits, r, rs);
+                return rebalance(left, centre, nullptr, ls);
+            }
+            if (ls < rs) {
+                const inner_node* right = as_inner(r);
+                inner_node* centre = concat_sub(l, ls, right->children[0], rs - bits);
+                return rebalance(nullptr, centre, right, rs);
+            }
+            if (ls == 0) {
+                inner_node* parent = new inner_node();
+                if (l->count + r->count <= width) {
+                    leaf_node* merged = leaf_from(as_leaf(l)->values(), l->count);
+                    for (uint32_t i = 0; i < r->count; i++) {
+                        new (merged->values() + merged->count) T(as_leaf(r)->values()[i]);
+                        merged->count++;
+                    }
+                    parent->children[0] = merged;
+                    parent->count = 1;
+                } else {
+                    retain(l);
+                    retain(r);
+                    parent->children[0] = const_cast<node*>(l);
+                    parent->children[1] = const_cast<node*>(r);
+                    parent->count = 2;
+                }
+                refresh(parent, bits);
+                return parent;
+            }
+            const inner_node* left = as_inner(l);
+            const inner_node* right = as_inner(r);
+            inner_node* centre = concat_sub(left->children[left->count - 1], ls - bits, right->children[0], rs - bits);
+            return rebalance(left, centre, right, ls);
+        }
+
+        /**
+         * @brief Redistributes the children of left (all but its last), centre and right
+         * (all but its first), all at shift - bits, into nodes at shift
+         * Consumes centre. @return Inner node at shift + bits holding one or two nodes
+         */
+        static inner_node* rebalance(const inner_node* left, inner_node* centre, const inner_node* right, unsigned shift) {
+            node* all[2 * width + 2];
+            uint32_t counts[2 * width + 2];
+            size_t n = 0;
+            if (left) {
+                for (uint32_t i = 0; i + 1 < left->count; i++) all[n++] = left->children[i];
+            }
+            for (uint32_t i = 0; i < centre->count; i++) all[n++] = centre->children[i];
+            if (right) {
+                for (uint32_t i = 1; i < right->count; i++) all[n++] = right->children[i];
+            }
+
+            // Plan: while more than optimal + extra_slots nodes, pour the first short node
+            // into its successors
+            size_t total = 0;
+            for (size_t i = 0; i < n; i++) {
+                counts[i] = all[i]->count;
+                total += counts[i];
+            }
+            const size_t optimal = (total + width - 1) / width;
+            size_t planned = n;
+            size_t i = 0;
+            while (planned > optimal + extra_slots) {
+                while (counts[i] > width - extra_slots / 2) i++;
+                size_t remaining = counts[i];
+                do {
+                    const size_t fill = std::min(remaining + counts[i + 1], width);
+                    remaining = remaining + counts[i + 1] - fill;
+                    counts[i] = static_cast<uint32_t>(fill);
+                    i++;
+                } while (remaining > 0);
+                for (size_t j = i; j + 1 < planned; j++) counts[j] = counts[j + 1];
+                planned--;
+                i--;
+            }
+
+            // Execute: reuse nodes the plan left intact, build the rest slot by slot
+            node* rebuilt[2 * width + 2];
+            const unsigned child_shift = shift - bits;
+            size_t src = 0;
+            uint32_t offset = 0;
+            for (size_t k = 0; k < planned; k++) {
+                const uint32_t want = counts[k];
+                if (offset == 0 && all[src]->count == want) {
+                    retain(all[src]);
+                    rebuilt[k] = all[src++];
+                    continue;
+                }
+                if (child_shift == 0) {
+                    leaf_node* leaf = new leaf_node();
+                    while (leaf->count < want) {
+                        const leaf_node* from = as_leaf(all[src]);
+                        const uint32_t take = std::min(want - leaf->count, from->count - offset);
+                        for (uint32_t t = 0; t < take; t++) {
+                            new (leaf->values() + leaf->count + t) T(from->values()[offset + t]);
+                        }
+                        leaf->count += take;
+                        offset += take;
+                        if (offset == from->count) { src++; offset = 0; }
+                    }
+                    rebuilt[k] = leaf;
+                } else {
+                    inner_node* inner = new inner_node();
+                    while (inner->count < want) {
+                        const inner_node* from = as_inner(all[src]);
+                        const uint32_t take = std::min(want - inner->count, from->count - offset);
+                        for (uint32_t t = 0; t < take; t++) {
+                            retain(from->children[offset + t]);
+                            inner->children[inner->count + t] = from->children[offset + t];
+                        }
+                        inner->count += take;
+                        offset += take;
+                        if (offset == from->count) { src++; offset = 0; }
+                    }
+                    refresh(inner, child_shift);
+                    rebuilt[k] = inner;
+                }
+            }
+            release(centre);
+
+            inner_node* parent = new inner_node();
+            const size_t first_count = std::min(planned, width);
+            for (size_t k = 0; k < planned; k += width) {
+                inner_node* group = new inner_node();
+                const size_t m = k == 0 ? first_count : planned - width;
+                for (size_t j = 0; j < m; j++) group->children[j] = rebuilt[k + j];
+                group->count = static_cast<uint32_t>(m);
+                refresh(group, shift);
+                parent->children[parent->count++] = group;
+            }
+            refresh(parent, shift + bits);
+            return parent;
+        }
+
+        // Slicing
+
+        /**
+         * @brief First count elements of the subtree n at shift (0 < count <= size)
+         */
+        static node* take(const node* n, unsigned shift, size_t count) {
+            if (count == size_of(n)) {
+                retain(n);
+                return const_cast<node*>(n);
+            }
+            if (n->leaf) return leaf_from(as_leaf(n)->values(), count);
+            const inner_node* in = as_inner(n);
+            size_t i = count - 1;
+            const uint32_t slot = child_slot(in, shift, i);
+            inner_node* out = new inner_node();
+            for (uint32_t j = 0; j < slot; j++) {
+                retain(in->children[j]);
+                out->children[j] = in->children[j];
+                out->sizes[j] = in->sizes[j];
+            }
+            out->children[slot] = take(in->children[slot], shift - bits, i + 1);
+            out->count = slot + 1;
+            refresh(out, shift, slot);
+            return out;
+        }
+
+        /**
+         * @brief Subtree n at shift without its first k elements (k < size)
+         */
+        static node* drop(const node* n, unsigned shift, size_t k) {
+            if (k == 0) {
+                retain(n);
+                return const_cast<node*>(n);
+            }
+            if (n->leaf) return leaf_from(as_leaf(n)->values() + k, n->count - k);
+            const inner_node* in = as_inner(n);
+            const uint32_t slot = child_slot(in, shift, k);
+            inner_node* out = new inner_node();
+            out->children[0] = drop(in->children[slot], shift - bits, k);
+            for (uint32_t j = slot + 1; j < in->count; j++) {
+                retain(in->children[j]);
+                out->children[j - slot] = in->children[j];
+            }
+            out->count = in->count - slot;
+            refresh(out, shift);
+            return out;
+        }
+
+        template <typename F>
+        static void for_each_in(const node* n, F& fn) {
+            if (n->leaf) {
+                const T* values = as_leaf(n)->values();
+                for (uint32_t i = 0; i < n->count; i++) fn(values[i]);
+            } else {
+                const inner_node* in = as_inner(n);
+                for (uint32_t i = 0; i < in->count; i++) for_each_in(in->children[i], fn);
+            }
+        }
+
+    public:
+        class transient_type;
+
+        persistent_vector() noexcept : _root(nullptr), _tail(nullptr), _shift(0), _size(0) {}
+
+        persistent_vector(std::initializer_list<T> init) : persistent_vector() {
+            for (const T& value : init) append(value);
+        }
+
+        persistent_vector(const persistent_vector& other) noexcept
+            : _root(other._root), _tail(other._tail), _shift(other._shift), _size(other._size) {
+            if (_root) retain(_root);
+            if (_tail) retain(_tail);
+        }
+
+        persistent_vector(persistent_vector&& other) noexcept
+            : _root(other._root), _tail(other._tail), _shift(other._shift), _size(other._size) {
+            other._root = other._tail = nullptr;
+            other._shift = 0;
+            other._size = 0;
+        }
+
+        persistent_vector& operator=(persistent_vector other) noexcept {
+            std::swap(_root, other._root);
+            std::swap(_tail, other._tail);
+            std::swap(_shift, other._shift);
+            std::swap(_size, other._size);
+            return *this;
+        }
+
+        ~persistent_vector() {
+            release(_root);
+            release(_tail);
+        }
+
+        size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return _size == 0; }
+
+        /**
+         * @brief Tree height in levels, leaves included; 0 while everything is in the tail
+         */
+        unsigned depth() const noexcept { return _root ? _shift / bits + 1 : 0; }
+
+        const T& operator[](size_t i) const {
+            const size_t tail_start = _size - tail_count();
+            if (i >= tail_start) return as_leaf(_tail)->values()[i - tail_start];
+            const node* n = _root;
+            unsigned shift = _shift;
+            while (!n->leaf) {
+                const inner_node* in = as_inner(n);
+                n = in->children[child_slot(in, shift, i)];
+                shift -= bits;
+            }
+            return as_leaf(n)->values()[i];
+        }
+
+        const T& back() const { return (*this)[_size - 1]; }
+
+        /**
+         * @brief Calls fn(element) in order, leaf by leaf
+         */
+        template <typename F>
+        void for_each(F&& fn) const {
+            if (_root) for_each_in(_root, fn);
+            if (_tail) for_each_in(_tail, fn);
+        }
+
+        /**
+         * @brief New version with value appended (copies the tail, at most 32 elements)
+         */
+        persistent_vector push_back(T value) const& {
+            persistent_vector out(*this);
+            out.append(std::move(value));
+            return out;
+        }
+
+        /**
+         * @brief Appends in place when this version's tail and path are unshared
+         */
+        persistent_vector push_back(T value) && {
+            append(std::move(value));
+            return std::move(*this);
+        }
+
+        /**
+         * @brief New version with element i replaced (copies one root-to-leaf path)
+         */
+        persistent_vector set(size_t i, T value) const& {
+            persistent_vector out(*this);
+            out.assign_at(i, std::move(value));
+            return out;
+        }
+
+        persistent_vector set(size_t i, T value) && {
+            assign_at(i, std::move(value));
+            return std::move(*this);
+        }
+
+        /**
+         * @brief This followed by other, sharing both trees except along the seam
+         */
+        persistent_vector concat(const persistent_vector& other) const {
+            if (other.empty()) return *this;
+            if (empty()) return other;
+            persistent_vector out(*this);
+            if (!other._root) {
+                const leaf_node* tail = as_leaf(other._tail);
+                for (uint32_t i = 0; i < tail->count; i++) out.append(tail->values()[i]);
+                return out;
+            }
+            if (out._tail) {
+                node* tail = out._tail;
+                out._tail = nullptr;
+                out.push_tail(tail);
+            }
+            if (!out._root) {
+                // Only an empty tail on the left
+                out._root = other._root;
+                retain(out._root);
+                out._shift = other._shift;
+            } else {
+                node* root = concat_sub(out._root, out._shift, other._root, other._shift);
+                release(out._root);
+                out._root = root;
+                out._shift = std::max(out._shift, other._shift) + bits;
+                collapse(out._root, out._shift);
+            }
+            out._tail = other._tail;
+            if (out._tail) retain(out._tail);
+            out._size += other._size;
+            return out;
+        }
+
+        /**
+         * @brief Elements [first, last) as a new version (last is clamped to size())
+         */
+        persistent_vector slice(size_t first, size_t last) const {
+            last = std::min(last, _size);
+            persistent_vector out;
+            if (first >= last) return out;
+            const size_t tail_start = _size - tail_count();
+            out._size = last - first;
+            if (first >= tail_start) {
+                out._tail = leaf_from(as_leaf(_tail)->values() + (first - tail_start), last - first);
+                return out;
+            }
+            if (last > tail_start) {
+                out._tail = leaf_from(as_leaf(_tail)->values(), last - tail_start);
+            }
+            node* head = take(_root, _shift, std::min(last, tail_start));
+            out._root = drop(head, _shift, first);
+            release(head);
+            out._shift = _shift;
+            collapse(out._root, out._shift);
+            return out;
+        }
+
+        /**
+         * @brief Builder for batched edits; this version is unaffected
+         */
+        transient_type transient() const { return transient_type(*this); }
+
+        /**
+         * @brief Mutable view of one version: nodes it copies or creates stay unshared, so
+         * later edits through it happen in place. persistent() hands the result back
+         */
+        class transient_type {
+        private:
+            persistent_vector _v;
+
+        public:
+            explicit transient_type(const persistent_vector& v) : _v(v) {}
+
+            size_t size() const noexcept { return _v.size(); }
+            const T& operator[](size_t i) const { return _v[i]; }
+
+            void push_back(T value) { _v.append(std::move(value)); }
+            void set(size_t i, T value) { _v.assign_at(i, std::move(value)); }
+
+            /**
+             * @brief The edited version; the transient is left empty
+             */
+            persistent_vector persistent() { return std::move(_v); }
+        };
+    };
+}
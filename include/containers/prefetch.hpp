@@ -0,0 +1,31 @@
+#pragma once
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+namespace shared {
+    /**
+     * @brief Hints the CPU to pull the cache line holding addr into all cache levels
+     * Compiles to nothing on toolchains without a prefetch intrinsic
+     */
+    inline void prefetch(const void* addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(addr, 0, 3);
+#elif defined(_MSC_VER)
+        _mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#else
+        (void)addr;
+#endif
+    }
+
+    /**
+     * @brief Prefetch with intent to write (PREFETCHW where supported)
+     */
+    inline void prefetch_write(const void* addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(addr, 1, 3);
+#else
+        prefetch(addr);
+#endif
+    }
+}
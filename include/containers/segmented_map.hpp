@@ -0,0 +1,292 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "hash.hpp"
+#include "map.hpp"
+
+/**
+ * @brief Extendible hash map: a directory of fixed-size open-addressing segments
+ *
+ * Algorithm:
+ * - The key's hash is finalized with fmix64; its top global_depth bits index a directory
+ *   of segment pointers and its low bits pick the home slot inside the segment
+ * - Each segment is a SegmentSlots-slot table probed with triangular steps like
+ *   shared::map, and has a local_depth: 2^(global_depth - local_depth) consecutive
+ *   directory entries point at it
+ * - A segment about to pass 7/8 load splits alone into two segments on its next hash
+ *   bit; if it was at global depth the directory doubles first (pointer copies only)
+ *
+ * Performance characteristics vs shared::map:
+ * - Growth rehashes one segment, never the whole table, so insertion latency has no
+ *   O(n) spikes and peak memory is the table plus two segments instead of old + new table
+ * - One extra dependent load (the directory entry) per lookup
+ * - Segments sit between 7/16 and 7/8 load; the higher split point (map grows at 0.75)
+ *   keeps steady-state memory close to map's, and segment-local probe chains stay short
+ *
+ * Limitations:
+ * - Not thread-safe; a split only touches one segment, so a per-segment lock could let
+ *   other segments keep serving (and growing) concurrently
+ * - No erase; an insertion throws std::length_error when it would double the directory
+ *   for a full segment whose keys cannot be told apart within 24 hash bits (e.g. they
+ *   all share one hash), rather than doubling the directory without bound
+ */
+
+namespace shared {
+    /**
+     * @tparam k Key type
+     * @tparam v Value type
+     * @tparam Hash Hash function object for keys (finalized with fmix64)
+     * @tparam SegmentSlots Slots per segment (power of 2)
+     */
+    template <typename k, typename v, typename Hash = hasher<k>, size_t SegmentSlots = 4096>
+    class segmented_map {
+        static_assert(SegmentSlots >= 16 && (SegmentSlots & (SegmentSlots - 1)) == 0,
+                      "SegmentSlots must be a power of 2 (at least 16)");
+
+    private:
+        struct Entry {
+            uint8_t state;  // 0: empty, 1: occupied
+            pair<k, v> data;
+
+            Entry() : state(0) {}
+
+            template<typename K, typename V>
+            void insert(K&& key, V&& value) {
+                data = pair<k, v>(std::forward<K>(key), std::forward<V>(value));
+                state = 1;
+            }
+        };
+
+        struct Segment {
+            uint32_t depth;
+            uint32_t size;
+            Entry slots[SegmentSlots];
+
+            explicit Segment(uint32_t d) : depth(d), size(0), slots() {}
+        };
+
+        static constexpr size_t max_segment_size = SegmentSlots / 8 * 7;
+        static constexpr uint32_t max_depth = 24;
+
+        std::vector<Segment*> directory;
+        uint32_t global_depth;
+        size_t m_size;
+        size_t m_segments;
+        Hash m_hash;
+
+        static size_t top_bits(uint64_t hash, uint32_t bits) noexcept {
+            return bits ? static_cast<size_t>(hash >> (64 - bits)) : 0;
+        }
+
+        uint64_t hash_key(const k& key) const noexcept {
+            return hashes::fmix64(static_cast<uint64_t>(m_hash(key)));
+        }
+
+        Segment* segment_for(uint64_t hash) const noexcept {
+            return directory[top_bits(hash, global_depth)];
+        }
+
+        /**
+         * @brief Slot holding key, or the empty slot where it belongs
+         */
+        static size_t find_slot(const Segment& s, const k& key, uint64_t hash) noexcept {
+            size_t index = hash & (SegmentSlots - 1);
+            for (size_t i = 1; ; i++) {
+                if (s.slots[index].state != 1 || s.slots[index].data.first == key) {
+                    return index;
+                }
+                index = (index + i) & (SegmentSlots - 1);
+            }
+        }
+
+        /**
+         * @brief Replaces old with two segments one bit deeper and repoints its directory range
+         * @param hash Any hash that maps to old
+         */
+        void split(Segment* old, uint64_t hash) {
+            if (old->depth == global_depth) {
+                // Bits where some key in old differs from the new one; none within reach
+                // means doubling (possibly repeatedly) could never relieve this segment
+                uint64_t diff = 0;
+                for (size_t i = 0; i < SegmentSlots; i++) {
+                    if (old->slots[i].state == 1) diff |= hash_key(old->slots[i].data.first) ^ hash;
+                }
+                if ((diff >> (64 - max_depth)) == 0) {
+                    throw std::length_error("segmented_map: segment keys do not separate within the directory depth limit");
+                }
+                std::vector<Segment*> doubled(directory.size() * 2);
+                for (size_t i = 0; i < directory.size(); i++) {
+                    doubled[2 * i] = doubled[2 * i + 1] = directory[i];
+                }
+                directory.swap(doubled);
+                global_depth++;
+            }
+
+            const uint32_t depth = old->depth + 1;
+            Segment* lo = new Segment(depth);
+            Segment* hi;
+            try {
+                hi = new Segment(depth);
+            } catch (...) {
+                delete lo;
+                throw;
+            }
+
+            for (size_t i = 0; i < SegmentSlots; i++) {
+                Entry& e = old->slots[i];
+                if (e.state == 1) {
+                    const uint64_t h = hash_key(e.data.first);
+                    Segment* target = (h >> (64 - depth)) & 1 ? hi : lo;
+                    const size_t index = find_slot(*target, e.data.first, h);
+                    target->slots[index].insert(std::move(e.data.first), std::move(e.data.second));
+                    target->size++;
+                }
+            }
+
+            // old covers 2^(global_depth - old->depth) entries starting at its prefix
+            const size_t span = size_t(1) << (global_depth - old->depth);
+            const size_t first = top_bits(hash, old->depth) * span;
+            for (size_t i = 0; i < span; i++) {
+                directory[first + i] = i < span / 2 ? lo : hi;
+            }
+            delete old;
+            m_segments++;
+        }
+
+        template <typename F>
+        void for_each_segment(F&& fn) const {
+            for (size_t i = 0; i < directory.size(); ) {
+                Segment* s = directory[i];
+                i += size_t(1) << (global_depth - s->depth);
+                fn(s);
+            }
+        }
+
+        void destroy() noexcept {
+            for_each_segment([](Segment* s) { delete s; });
+            directory.clear();
+        }
+
+    public:
+        segmented_map() : directory(1, nullptr), global_depth(0), m_size(0), m_segments(1) {
+            directory[0] = new Segment(0);
+        }
+
+        ~segmented_map() noexcept {
+            destroy();
+        }
+
+        segmented_map(segmented_map&& other) noexcept
+            : directory(std::move(other.directory))
+            , global_depth(other.global_depth)
+            , m_size(other.m_size)
+            , m_segments(other.m_segments)
+            , m_hash(std::move(other.m_hash)) {
+            other.directory.clear();
+            other.global_depth = 0;
+            other.m_size = 0;
+            other.m_segments = 0;
+        }
+
+        segmented_map& operator=(segmented_map&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                directory = std::move(other.directory);
+                global_depth = other.global_depth;
+                m_size = other.m_size;
+                m_segments = other.m_segments;
+                m_hash = std::move(other.m_hash);
+                other.directory.clear();
+                other.global_depth = 0;
+                other.m_size = 0;
+                other.m_segments = 0;
+            }
+            return *this;
+        }
+
+        segmented_map(const segmented_map&) = delete;
+        segmented_map& operator=(const segmented_map&) = delete;
+
+        /**
+         * @brief Inserts key with a value constructed from args unless key is present
+         * Only the key's segment splits, and only when a new entry would overfill it
+         * @return Pointer to the key's value and whether it was inserted
+         */
+        template <typename... Args>
+        pair<v*, bool> try_emplace(const k& key, Args&&... args) {
+            const uint64_t hash = hash_key(key);
+            for (;;) {
+                Segment* s = segment_for(hash);
+                const size_t index = find_slot(*s, key, hash);
+                if (s->slots[index].state == 1) {
+                    return pair<v*, bool>(&s->slots[index].data.second, false);
+                }
+                if (s->size + 1 > max_segment_size) {
+                    split(s, hash);
+                    continue;
+                }
+                s->slots[index].insert(key, v(std::forward<Args>(args)...));
+                s->size++;
+                m_size++;
+                return pair<v*, bool>(&s->slots[index].data.second, true);
+            }
+        }
+
+        /**
+         * @brief Access or insert element
+         */
+        v& operator[](const k& key) {
+            return *try_emplace(key).first;
+        }
+
+        const v* find(const k& key) const noexcept {
+            const uint64_t hash = hash_key(key);
+            const Segment* s = segment_for(hash);
+            const size_t index = find_slot(*s, key, hash);
+            return s->slots[index].state == 1 ? &s->slots[index].data.second : nullptr;
+        }
+
+        v* find(const k& key) noexcept {
+            return const_cast<v*>(static_cast<const segmented_map*>(this)->find(key));
+        }
+
+        /**
+         * @brief Calls fn(key, value) for every element, segment by segment
+         */
+        template <typename F>
+        void for_each(F&& fn) {
+            for_each_segment([&fn](Segment* s) {
+                for (size_t i = 0; i < SegmentSlots; i++) {
+                    if (s->slots[i].state == 1) {
+                        fn(static_cast<const k&>(s->slots[i].data.first), s->slots[i].data.second);
+                    }
+                }
+            });
+        }
+
+        /**
+         * @brief Removes all elements, keeping a single empty segment
+         */
+        void clear() {
+            destroy();
+            directory.assign(1, new Segment(0));
+            global_depth = 0;
+            m_size = 0;
+            m_segments = 1;
+        }
+
+        size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        size_t segment_count() const noexcept { return m_segments; }
+        uint32_t depth() const noexcept { return global_depth; }
+        size_t bucket_count() const noexcept { return m_segments * SegmentSlots; }
+        float load_factor() const noexcept { return static_cast<float>(m_size) / bucket_count(); }
+
+        size_t memory_bytes() const noexcept {
+            return m_segments * sizeof(Segment) + directory.capacity() * sizeof(Segment*);
+        }
+    };
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Non-temporal (streaming) bulk copy and fill with runtime CPU dispatch
+ *
+ * Algorithm:
+ * - The destination is brought to a 64-byte boundary with ordinary stores, the body
+ *   is written in 64-byte blocks with movnt stores (SSE2, AVX2 or AVX-512, picked once
+ *   from CPUID), the tail again with ordinary stores, then an sfence orders the
+ *   weakly-ordered streaming stores before anything that follows
+ * - Fills stream a 64-byte block holding the value repeated, so only element sizes
+ *   that divide 64 take the streaming path
+ *
+ * Performance characteristics:
+ * - Streaming stores bypass the cache hierarchy: no read-for-ownership of destination
+ *   lines and no eviction of other data (including other cores' data in the shared LLC)
+ * - Slower than regular stores when the destination is read soon after or fits in cache,
+ *   hence the size threshold (8 MB by default, see threshold())
+ *
+ * Limitations:
+ * - x86-64 only; elsewhere copy()/fill() fall back to memcpy and ordinary stores
+ * - AVX2/AVX-512 kernels need GCC or Clang (target attributes); MSVC uses SSE2
+ */
+
+namespace shared {
+    namespace streaming {
+        enum class isa { none, sse2, avx2, avx512 };
+
+        /**
+         * @brief Byte size from which containers switch bulk copies and fills to streaming stores
+         * Set to SIZE_MAX to disable streaming
+         */
+        inline size_t& threshold() noexcept {
+            static size_t bytes = size_t(8) << 20;
+            return bytes;
+        }
+
+        inline bool worthwhile(size_t bytes) noexcept {
+            return bytes >= threshold();
+        }
+
+        namespace detail {
+            // Streams blocks of 64 bytes to 64-byte aligned dst; src advances by src_step (0 repeats one block)
+            using block_fn = void (*)(char* dst, const char* src, size_t blocks, size_t src_step);
+
+            inline void memcpy_blocks(char* dst, const char* src, size_t blocks, size_t src_step) {
+                for (size_t i = 0; i < blocks; ++i, dst += 64, src += src_step) {
+                    std::memcpy(dst, src, 64);
+                }
+            }
+
+#if defined(__x86_64__) || defined(_M_X64)
+            inline void stream_blocks_sse2(char* dst, const char* src, size_t blocks, size_t src_step) {
+                for (size_t i = 0; i < blocks; ++i, dst += 64, src += src_step) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+                    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+                    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+                    _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+                    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+                    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+                    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+                }
+            }
+
+#if defined(__GNUC__) || defined(__clang__)
+            __attribute__((target("avx2")))
+            inline void stream_blocks_avx2(char* dst, const char* src, size_t blocks, size_t src_step) {
+                for (size_t i = 0; i < blocks; ++i, dst += 64, src += src_step) {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+                    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+                    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+                }
+            }
+
+            __attribute__((target("avx512f")))
+            inline void stream_blocks_avx512(char* dst, const char* src, size_t blocks, size_t src_step) {
+                for (size_t i = 0; i < blocks; ++i, dst += 64, src += src_step) {
+                    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), _mm512_loadu_si512(src));
+                }
+            }
+#endif
+#endif
+
+            inline isa detect() noexcept {
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f")) return isa::avx512;
+                if (__builtin_cpu_supports("avx2")) return isa::avx2;
+                return isa::sse2;
+#elif defined(__x86_64__) || defined(_M_X64)
+                return isa::sse2;
+#else
+                return isa::none;
+#endif
+            }
+
+            inline block_fn kernel_for(isa level) noexcept {
+                switch (level) {
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__GNUC__) || defined(__clang__)
+                    case isa::avx512: return stream_blocks_avx512;
+                    case isa::avx2: return stream_blocks_avx2;
+#endif
+                    case isa::sse2: return stream_blocks_sse2;
+#endif
+                    default: return memcpy_blocks;
+                }
+            }
+
+            inline void fence() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+                _mm_sfence();
+#endif
+            }
+        }
+
+        /**
+         * @brief Instruction set used for streaming stores on this CPU (detected once)
+         */
+        inline isa active_isa() noexcept {
+            static const isa level = detail::detect();
+            return level;
+        }
+
+        inline const char* isa_name(isa level) noexcept {
+            switch (level) {
+                case isa::sse2: return "sse2";
+                case isa::avx2: return "avx2";
+                case isa::avx512: return "avx512";
+                default: return "none";
+            }
+        }
+
+        /**
+         * @brief memcpy with streaming stores for the 64-byte aligned body of dst
+         */
+        inline void copy(void* dst, const void* src, size_t bytes) noexcept {
+            static const detail::block_fn kernel = detail::kernel_for(active_isa());
+            char* d = static_cast<char*>(dst);
+            const char* s = static_cast<const char*>(src);
+            if (bytes == 0) return;
+            if (bytes < 256 || active_isa() == isa::none) {
+                std::memcpy(d, s, bytes);
+                return;
+            }
+            const size_t head = (64 - reinterpret_cast<uintptr_t>(d) % 64) % 64;
+            std::memcpy(d, s, head);
+            d += head;
+            s += head;
+            bytes -= head;
+
+            const size_t blocks = bytes / 64;
+            kernel(d, s, blocks, 64);
+            detail::fence();
+            std::memcpy(d + blocks * 64, s + blocks * 64, bytes - blocks * 64);
+        }
+
+        /**
+         * @brief Writes count copies of value to raw storage at dst, streaming the aligned body
+         * T must be trivially copyable; elements are created byte-wise
+         */
+        template <typename T>
+        void fill(T* dst, size_t count, const T& value) noexcept {
+            static_assert(std::is_trivially_copyable_v<T>, "streaming fill needs trivially copyable elements");
+            static const detail::block_fn kernel = detail::kernel_for(active_isa());
+            char* d = reinterpret_cast<char*>(dst);
+            size_t i = 0;
+            if (64 % sizeof(T) == 0 && active_isa() != isa::none && count * sizeof(T) >= 256) {
+                // Element stores until dst is block aligned; an element size that never
+                // lands on the boundary leaves i at the cap and falls through to the plain loop
+                while (i < 64 / sizeof(T) && reinterpret_cast<uintptr_t>(d + i * sizeof(T)) % 64 != 0) {
+                    std::memcpy(d + i * sizeof(T), &value, sizeof(T));
+                    ++i;
+                }
+                if (reinterpret_cast<uintptr_t>(d + i * sizeof(T)) % 64 == 0) {
+                    alignas(64) char pattern[64];
+                    for (size_t k = 0; k < 64; k += sizeof(T)) std::memcpy(pattern + k, &value, sizeof(T));
+                    const size_t blocks = (count - i) * sizeof(T) / 64;
+                    kernel(d + i * sizeof(T), pattern, blocks, 0);
+                    detail::fence();
+                    i += blocks * 64 / sizeof(T);
+                }
+            }
+            for (; i < count; ++i) {
+                std::memcpy(d + i * sizeof(T), &value, sizeof(T));
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size worker pool with a single FIFO task queue
+ *
+ * Performance characteristics:
+ * - Threads are created once; submitting a task costs one lock and one notify
+ * - Intended for coarse tasks (chunks of a scan or parse, batched I/O), not
+ *   for fine-grained work where the shared queue lock would dominate
+ * - An optional start hook runs on each worker before it takes tasks
+ *   (e.g. numa::spread_workers() to pin workers across NUMA nodes)
+ *
+ * Limitations:
+ * - No work stealing or task priorities
+ * - Tasks must not block waiting on tasks queued behind them
+ */
+
+namespace shared {
+    class thread_pool {
+    private:
+        std::vector<std::thread> _workers;
+        std::deque<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _ready;
+        bool _stop;
+
+        static size_t& current_worker() noexcept {
+            static thread_local size_t index = npos;
+            return index;
+        }
+
+        void worker_loop(size_t index, const std::function<void(size_t)>& on_start) {
+            current_worker() = index;
+            if (on_start) on_start(index);
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _ready.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                    if (_stop && _tasks.empty()) return;
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        /**
+         * @brief Starts `threads` workers (at least one)
+         * @param on_start Called on each worker with its index before it takes tasks
+         */
+        explicit thread_pool(size_t threads = std::thread::hardware_concurrency(),
+                             std::function<void(size_t)> on_start = nullptr)
+            : _stop(false)
+        {
+            if (threads == 0) threads = 1;
+            _workers.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                _workers.emplace_back([this, i, on_start] { worker_loop(i, on_start); });
+            }
+        }
+
+        /**
+         * @brief Finishes all queued tasks, then joins the workers
+         */
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _ready.notify_all();
+            for (auto& worker : _workers) {
+                worker.join();
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        size_t size() const noexcept { return _workers.size(); }
+
+        /**
+         * @brief Index of the calling pool worker, or npos off the pool
+         */
+        static size_t worker_index() noexcept { return current_worker(); }
+
+        /**
+         * @brief Queues fn and returns a future for its result (exceptions propagate through it)
+         */
+        template <typename F>
+        auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using result_t = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(fn));
+            std::future<result_t> result = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.emplace_back([task] { (*task)(); });
+            }
+            _ready.notify_one();
+            return result;
+        }
+
+        /**
+         * @brief Runs fn(i) for i in [0, count) as separate tasks and waits for all of them
+         * The first exception thrown by a task is rethrown after every task finished
+         */
+        template <typename F>
+        void parallel_for(size_t count, F&& fn) {
+            std::vector<std::future<void>> pending;
+            pending.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                pending.push_back(submit([&fn, i] { fn(i); }));
+            }
+            std::exception_ptr error;
+            for (auto& f : pending) {
+                try {
+                    f.get();
+                }
+                catch (...) {
+                    if (!error) error = std::current_exception();
+                }
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+        /**
+         * @brief Runs fn(worker_index) exactly once on every worker and waits
+         * Each task blocks until all workers hold one, which pins the task-to-worker
+         * mapping; use it when work must run on a specific worker (first-touch placement).
+         * Must not be called from a pool worker
+         */
+        template <typename F>
+        void for_each_worker(F&& fn) {
+            const size_t n = size();
+            std::mutex mutex;
+            std::condition_variable all_arrived;
+            size_t arrived = 0;
+            parallel_for(n, [&](size_t) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (++arrived == n) all_arrived.notify_all();
+                    else all_arrived.wait(lock, [&] { return arrived == n; });
+                }
+                fn(worker_index());
+            });
+        }
+    };
+}
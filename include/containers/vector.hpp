@@ -1,4 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "numa.hpp"
+#include "page_alloc.hpp"
+#include "prefetch.hpp"
+#include "streaming_store.hpp"
+#include "thread_pool.hpp"
 
 /**
  * @brief A custom vector implementation with unique features and comparable performance to std::vector
@@ -12,6 +20,14 @@
  * - Custom deleter support for specialized cleanup of elements
  * - Move semantics prioritized over copying for better performance with movable types
  * - Manual memory management using placement new/delete for more control
+ * - Parallel construction/resize on a thread_pool with NUMA-aware page placement
+ * - Optional page-level allocation (huge pages, prefault, release on shrink), see alloc_options
+ * - Bulk copy/fill of trivially copyable elements above streaming::threshold() uses
+ *   non-temporal stores, leaving the cache to other work
+ * - ranges(n) splits the elements into line-aligned ranges for parallel scans
+ *   (see parallel_for_each in parallel.hpp)
+ * - Constructible from and assignable from lazy elementwise expressions
+ *   (c = a * x + b in one pass, see vector_expr.hpp)
  * 
  * Areas for improvement:
  * - Exception handling needs to be implemented (currently missing in at())
@@ -29,6 +45,12 @@ namespace shared {
     template<typename T>
     using deleter_fn = void(*)(T&&);
 
+    template<class E>
+    struct vector_expression;   // Lazy elementwise expressions, see vector_expr.hpp
+
+    template<class E>
+    inline constexpr bool is_vector_expression_v = std::is_base_of_v<vector_expression<E>, E>;
+
     template<class T>
     class vector {
     private:
@@ -36,6 +58,45 @@ namespace shared {
         T* _elements;      // Pointer to elements array
         size_t _space;     // Total allocated capacity
         deleter_fn<T> _deleter;  // Optional custom cleanup function
+        alloc_options _alloc;    // Page-level allocation options (THP, prefault)
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(pages::allocate(n * sizeof(T), _alloc));
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            pages::deallocate(p, n * sizeof(T), _alloc);
+        }
+
+        /**
+         * @brief Copy-constructs n elements from src into raw storage at dst
+         */
+        static void construct_copies(T* dst, const T* src, size_t n) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (streaming::worthwhile(n * sizeof(T))) {
+                    streaming::copy(dst, src, n * sizeof(T));
+                    return;
+                }
+            }
+            for (size_t i = 0; i < n; i++) {
+                new (dst + i) T(src[i]);
+            }
+        }
+
+        /**
+         * @brief Constructs n copies of val into raw storage at dst
+         */
+        static void construct_fill(T* dst, size_t n, const T& val) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (streaming::worthwhile(n * sizeof(T))) {
+                    streaming::fill(dst, n, val);
+                    return;
+                }
+            }
+            for (size_t i = 0; i < n; i++) {
+                new (dst + i) T(val);
+            }
+        }
 
         /**
          * @brief Cleans up all elements and deallocates memory
@@ -47,19 +108,74 @@ namespace shared {
                     if (_deleter) _deleter(std::move(_elements[i]));
                     else _elements[i].~T();
                 }
-                ::operator delete(_elements);
+                deallocate(_elements, _space);
                 _elements = nullptr;
             }
             _size = _space = 0;
         }
 
+        /**
+         * @brief Grows to new_size, moving existing elements and copy-constructing val
+         * into the rest, one page-aligned chunk per pool worker
+         * Chunk w is always handled by worker w, so with first_touch its pages are
+         * faulted in on the node that worker is pinned to
+         */
+        void parallel_grow(size_t new_size, const T& val, thread_pool& pool, numa_placement placement) {
+            const bool reallocate = new_size > _space;
+            T* dst = reallocate ? allocate(new_size) : _elements;
+            if (placement == numa_placement::interleave) {
+                const size_t first = reallocate ? 0 : _size;
+                numa::interleave(dst + first, (new_size - first) * sizeof(T));
+            }
+
+            const size_t old_size = _size;
+            T* src = _elements;
+            auto fill = [&](size_t first, size_t last) {
+                if (reallocate) {
+                    for (size_t i = first; i < std::min(last, old_size); i++) {
+                        new (dst + i) T(std::move(src[i]));
+                        src[i].~T();
+                    }
+                }
+                for (size_t i = std::max(first, old_size); i < last; i++) {
+                    new (dst + i) T(val);
+                }
+            };
+
+            if (placement == numa_placement::serial || pool.size() == 1) {
+                fill(0, new_size);
+            }
+            else {
+                const size_t workers = pool.size();
+                pool.for_each_worker([&](size_t worker) {
+                    auto chunk = numa::page_chunk(dst, new_size, sizeof(T), worker, workers);
+                    fill(chunk.first, chunk.second);
+                });
+            }
+
+            if (reallocate) {
+                deallocate(_elements, _space);
+                _elements = dst;
+                _space = new_size;
+            }
+            _size = new_size;
+        }
+
     public:
         /**
          * @brief Default constructor
          * @param custom_deleter Optional function for custom element cleanup
          */
         vector(deleter_fn<T> custom_deleter = nullptr)
-            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter) {}
+            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter), _alloc() {}
+
+        /**
+         * @brief Empty vector whose storage is allocated with the given page-level options
+         * Options are kept for every later allocation and carried by copies and moves
+         * @param options Huge pages, prefault and release-on-shrink, see alloc_options
+         */
+        explicit vector(const alloc_options& options, deleter_fn<T> custom_deleter = nullptr)
+            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter), _alloc(options) {}
 
         /**
          * @brief Constructs vector with given size, default-initializing elements
@@ -67,10 +183,10 @@ namespace shared {
          * @param custom_deleter Optional function for custom element cleanup
          */
         explicit vector(size_t s, deleter_fn<T> custom_deleter = nullptr)
-            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter)
+            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter), _alloc()
         {
             if (s > 0) {
-                _elements = static_cast<T*>(::operator new(s * sizeof(T)));
+                _elements = allocate(s);
                 _space = s;
                 for (size_t i = 0; i < s; i++) {
                     new (_elements + i) T();
@@ -79,20 +195,30 @@ namespace shared {
             }
         }
 
+        /**
+         * @brief Constructs s copies of val in parallel on pool
+         * Pin the pool's workers (numa::spread_workers()) for first_touch to place each
+         * chunk on its worker's node; scan with numa::page_chunk for node-local access
+         * @param placement Page placement policy, see numa_placement
+         */
+        vector(size_t s, const T& val, thread_pool& pool,
+               numa_placement placement = numa_placement::first_touch, deleter_fn<T> custom_deleter = nullptr)
+            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter), _alloc()
+        {
+            if (s > 0) parallel_grow(s, val, pool, placement);
+        }
+
         /**
          * @brief Copy constructor
          * Creates deep copy of other vector's elements
          */
         vector(const vector& other)
-            : _size(0), _elements(nullptr), _space(0), _deleter(other._deleter)
+            : _size(0), _elements(nullptr), _space(0), _deleter(other._deleter), _alloc(other._alloc)
         {
             if (other._size > 0) {
-                _elements = static_cast<T*>(::operator new(other._size * sizeof(T)));
+                _elements = allocate(other._size);
                 _space = _size = other._size;
-
-                for (size_t i = 0; i < _size; i++) {
-                    new (_elements + i) T(other._elements[i]);
-                }
+                construct_copies(_elements, other._elements, _size);
             }
         }
 
@@ -101,7 +227,7 @@ namespace shared {
          * Transfers ownership of other vector's resources
          */
         vector(vector&& other) noexcept
-            : _size(other._size), _elements(other._elements), _space(other._space), _deleter(other._deleter)
+            : _size(other._size), _elements(other._elements), _space(other._space), _deleter(other._deleter), _alloc(other._alloc)
         {
             other._elements = nullptr;
             other._size = other._space = 0;
@@ -113,7 +239,7 @@ namespace shared {
          */
         template<class U>
         vector(std::initializer_list<U> init, deleter_fn<T> custom_deleter = nullptr)
-            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter)
+            : _size(0), _elements(nullptr), _space(0), _deleter(custom_deleter), _alloc()
         {
             reserve(init.size());
             for (const auto& item : init) {
@@ -129,14 +255,12 @@ namespace shared {
             if (this == &other) return *this;
 
             clean_up();
+            _alloc = other._alloc;
 
             if (other._size > 0) {
-                _elements = static_cast<T*>(::operator new(other._size * sizeof(T)));
+                _elements = allocate(other._size);
                 _space = _size = other._size;
-
-                for (size_t i = 0; i < _size; i++) {
-                    new (_elements + i) T(other._elements[i]);
-                }
+                construct_copies(_elements, other._elements, _size);
             }
             _deleter = other._deleter;
             return *this;
@@ -153,12 +277,33 @@ namespace shared {
                 _size = other._size;
                 _space = other._space;
                 _deleter = other._deleter;
+                _alloc = other._alloc;
                 other._elements = nullptr;
                 other._size = other._space = 0;
             }
             return *this;
         }
 
+        /**
+         * @brief Evaluates an elementwise expression (vector_expr.hpp) in one pass
+         */
+        template<class E, typename = std::enable_if_t<is_vector_expression_v<E>>>
+        vector(const E& expr)
+            : _size(0), _elements(nullptr), _space(0), _deleter(nullptr), _alloc()
+        {
+            expr.evaluate_into(*this);
+        }
+
+        /**
+         * @brief Overwrites the elements with an expression's values in one pass
+         * The expression may read this vector (v = v * 2 + w)
+         */
+        template<class E, typename = std::enable_if_t<is_vector_expression_v<E>>>
+        vector& operator=(const E& expr) {
+            expr.evaluate_into(*this);
+            return *this;
+        }
+
         ~vector() {
             clean_up();
         }
@@ -190,14 +335,14 @@ namespace shared {
         void reserve(size_t new_alloc) {
             if (new_alloc <= _space) return;
 
-            T* new_elements = static_cast<T*>(::operator new(new_alloc * sizeof(T)));
+            T* new_elements = allocate(new_alloc);
 
             for (size_t i = 0; i < _size; i++) {
                 new (new_elements + i) T(std::move(_elements[i]));
                 _elements[i].~T();
             }
 
-            ::operator delete(_elements);
+            deallocate(_elements, _space);
             _elements = new_elements;
             _space = new_alloc;
         }
@@ -212,17 +357,66 @@ namespace shared {
                 while (_size > new_size) {
                     _elements[--_size].~T();
                 }
+                if (_alloc.release_on_shrink) {
+                    pages::release(_elements + _size, (_space - _size) * sizeof(T));
+                }
             }
             else {
                 if (new_size > _space) {
                     reserve(new_size);
                 }
-                while (_size < new_size) {
-                    new (_elements + _size++) T(val);
-                }
+                construct_fill(_elements + _size, new_size - _size, val);
+                _size = new_size;
             }
         }
 
+        /**
+         * @brief Resizes without initializing new elements, for callers that overwrite
+         * all of them (file reads, decoders); saves the write pass resize() makes
+         * Growing reserves exactly new_size. Trivially copyable T only
+         */
+        void resize_uninitialized(size_t new_size) {
+            static_assert(std::is_trivially_copyable_v<T>, "resize_uninitialized needs a trivially copyable T");
+            if (new_size <= _size) {
+                resize(new_size);
+                return;
+            }
+            reserve(new_size);
+            _size = new_size;
+        }
+
+        /**
+         * @brief Resizes vector, constructing (and on reallocation, moving) elements in parallel on pool
+         * Shrinking is serial, as in resize(new_size, val)
+         */
+        void resize(size_t new_size, const T& val, thread_pool& pool,
+                    numa_placement placement = numa_placement::first_touch) {
+            if (new_size <= _size) resize(new_size, val);
+            else parallel_grow(new_size, val, pool, placement);
+        }
+
+        /**
+         * @brief Replaces the contents with n copies of val
+         */
+        void assign(size_t n, const T& val) {
+            const T value(val);   // val may refer to an element about to be destroyed
+            while (_size > 0) _elements[--_size].~T();
+            reserve(n);
+            construct_fill(_elements, n, value);
+            _size = n;
+        }
+
+        /**
+         * @brief Replaces the contents with copies of [first, first + n)
+         * first must not point into this vector
+         */
+        void assign(const T* first, size_t n) {
+            while (_size > 0) _elements[--_size].~T();
+            reserve(n);
+            construct_copies(_elements, first, n);
+            _size = n;
+        }
+
         /**
          * @brief Adds element to end (copy version)
          * Automatically grows container if needed
@@ -283,9 +477,55 @@ namespace shared {
         bool empty() const { return _size == 0; }
         size_t size() const { return _size; }
         size_t capacity() const { return _space; }
+        const alloc_options& alloc() const { return _alloc; }
+        deleter_fn<T> deleter() const { return _deleter; }
         T* data() { return _elements; }
         const T* data() const { return _elements; }
 
+        /**
+         * @brief Disjoint run of elements [first, last) from ranges()
+         * for_each prefetches a fixed distance ahead of the element it visits
+         */
+        struct range {
+            T* first;
+            T* last;
+
+            iterator begin() const { return iterator(first); }
+            iterator end() const { return iterator(last); }
+            size_t size() const { return static_cast<size_t>(last - first); }
+
+            template <typename F>
+            void for_each(F&& fn) const {
+                constexpr size_t per_line = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+                constexpr size_t ahead = per_line * 16;  // 1 KB for sub-line elements
+                for (T* p = first; p < last; p += per_line) {
+                    if (static_cast<size_t>(last - p) > ahead) prefetch(p + ahead);
+                    T* line_end = static_cast<size_t>(last - p) < per_line ? last : p + per_line;
+                    for (T* q = p; q < line_end; ++q) fn(*q);
+                }
+            }
+        };
+
+        /**
+         * @brief Splits the elements into n disjoint ranges covering them in order
+         * Boundaries are multiples of a 64-byte line's worth of elements, so workers
+         * writing through neighbouring ranges do not share cache lines (for a
+         * line-aligned buffer); with fewer lines than n the trailing ranges are empty
+         */
+        std::vector<range> ranges(size_t n) {
+            std::vector<range> parts;
+            if (n == 0) return parts;
+            parts.reserve(n);
+            constexpr size_t per_line = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+            const size_t lines = (_size + per_line - 1) / per_line;
+            for (size_t i = 0; i < n; i++) {
+                const size_t first = std::min(lines * i / n * per_line, _size);
+                const size_t last = std::min(lines * (i + 1) / n * per_line, _size);
+                parts.push_back(range{_elements + first, _elements + last});
+            }
+            return parts;
+        }
+
         // Element access methods
         T& front() { return _elements[0]; }
         const T& front() const { return _elements[0]; }
@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+/**
+ * @brief Lazy elementwise expressions over shared::vector of arithmetic types
+ *
+ * Arithmetic operators (+ - * / and unary -) on vectors, scalars and expressions build
+ * an expression tree instead of a result; nothing is computed until the tree is
+ * assigned to a vector:
+ *
+ *     shared::vector<float> c = a * x + b;   // one pass, no temporaries
+ *     c = (a - b) / (a + b);
+ *     shared::evaluate(c, a * x + b, pool);  // the same pass split over a thread_pool
+ *
+ * transform(e, fn) and transform(l, r, fn) lift any elementwise function into a node.
+ *
+ * Performance characteristics:
+ * - Each assignment is one loop reading every operand once and writing the
+ *   destination once; a chain of k operators with temporaries would write k - 1
+ *   intermediate vectors
+ * - The loop runs in fixed blocks marked free of loop-carried dependences, so the
+ *   compiler vectorizes it without runtime alias checks (also at GCC's -O2 cost model)
+ * - A floating scalar takes the element type of floating vectors (a * 2.0 on floats
+ *   stays float); integral scalars promote with integral elements (std::common_type);
+ *   a floating scalar with integral elements is a compile error, not a truncation
+ * - evaluate(dst, e, pool) splits the range into line-aligned chunks, several per
+ *   worker; short vectors (< parallel_threshold elements) evaluate on the caller
+ *
+ * Aliasing: the destination may appear in the expression (a = a * 2 + b); each
+ * element is read before it is written at the same index, and sizes must already match
+ *
+ * Limitations:
+ * - Expressions reference their vector operands: one stored with auto must not outlive
+ *   them (auto e = make() * 2 dangles), as with other expression-template libraries
+ * - Operand sizes must agree (std::invalid_argument when the node is built)
+ * - No reductions, broadcasts or shifted (stencil) access
+ */
+
+#if defined(__clang__)
+#define SHARED_EXPR_INDEPENDENT_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define SHARED_EXPR_INDEPENDENT_LOOP _Pragma("GCC ivdep")
+#else
+#define SHARED_EXPR_INDEPENDENT_LOOP
+#endif
+
+namespace shared {
+    /**
+     * @brief Expression evaluated into a vector; serial evaluation runs when assigned
+     */
+    template <class E>
+    struct vector_expression {
+        const E& derived() const noexcept { return static_cast<const E&>(*this); }
+
+        template <class U>
+        void evaluate_into(vector<U>& dst) const;
+    };
+
+    namespace expr {
+        static constexpr size_t block = 16;  // Elements per vectorized step; a line of floats
+        static constexpr size_t parallel_threshold = size_t(1) << 15;
+        static constexpr size_t scalar_size = static_cast<size_t>(-1);
+
+        template <class T>
+        struct terminal : vector_expression<terminal<T>> {
+            using value_type = T;
+            const T* elements;
+            size_t n;
+
+            explicit terminal(const vector<T>& v) noexcept : elements(v.data()), n(v.size()) {}
+            T operator[](size_t i) const noexcept { return elements[i]; }
+            size_t size() const noexcept { return n; }
+        };
+
+        /**
+         * @brief Broadcast value; a leaf only, never an expression on its own
+         */
+        template <class T>
+        struct scalar {
+            using value_type = T;
+            T value;
+
+            T operator[](size_t) const noexcept { return value; }
+            size_t size() const noexcept { return scalar_size; }
+        };
+
+        template <class F, class A>
+        struct unary : vector_expression<unary<F, A>> {
+            using value_type = std::decay_t<std::invoke_result_t<const F&, typename A::value_type>>;
+            A a;
+            F fn;
+
+            unary(A arg, F f) : a(std::move(arg)), fn(std::move(f)) {}
+            value_type operator[](size_t i) const { return fn(a[i]); }
+            size_t size() const noexcept { return a.size(); }
+        };
+
+        template <class F, class L, class R>
+        struct binary : vector_expression<binary<F, L, R>> {
+            using value_type = std::decay_t<std::invoke_result_t<const F&, typename L::value_type, typename R::value_type>>;
+            L l;
+            R r;
+            F fn;
+            size_t n;
+
+            binary(L lhs, R rhs, F f) : l(std::move(lhs)), r(std::move(rhs)), fn(std::move(f)), n(l.size()) {
+                if (n == scalar_size) n = r.size();
+                else if (r.size() != scalar_size && r.size() != n) {
+                    throw std::invalid_argument("vector expression: operand sizes differ");
+                }
+            }
+            value_type operator[](size_t i) const { return fn(l[i], r[i]); }
+            size_t size() const noexcept { return n; }
+        };
+
+        template <class X>
+        struct is_arithmetic_vector : std::false_type {};
+        template <class T>
+        struct is_arithmetic_vector<vector<T>> : std::is_arithmetic<T> {};
+
+        template <class X>
+        inline constexpr bool is_node_v = is_arithmetic_vector<X>::value || std::is_base_of_v<vector_expression<X>, X>;
+
+        template <class X>
+        inline constexpr bool is_scalar_v = std::is_arithmetic_v<X>;
+
+        template <class L, class R>
+        inline constexpr bool is_operand_pair_v =
+            (is_node_v<L> && (is_node_v<R> || is_scalar_v<R>)) || (is_scalar_v<L> && is_node_v<R>);
+
+        template <class X>
+        struct node_of {
+            using type = X;
+            static const X& make(const X& x) noexcept { return x; }
+        };
+
+        template <class T>
+        struct node_of<vector<T>> {
+            using type = terminal<T>;
+            static terminal<T> make(const vector<T>& v) noexcept { return terminal<T>(v); }
+        };
+
+        /**
+         * @brief Node for x. A floating scalar next to floating elements takes their type
+         * (a * 2.0 on floats stays float); an integral scalar next to integral elements
+         * promotes with them (std::common_type); an integral scalar next to floating
+         * elements converts to them. A floating scalar next to integral elements does not
+         * compile: truncating it (v * 2.5 as v * 2, v / 0.5 as v / 0) would be wrong
+         */
+        template <class Other, class X>
+        auto as_node(const X& x) {
+            if constexpr (is_scalar_v<X>) {
+                using E = typename node_of<Other>::type::value_type;
+                static_assert(!(std::is_floating_point_v<X> && std::is_integral_v<E>),
+                              "vector expression: floating scalar with integral elements; "
+                              "convert the vector or the scalar explicitly");
+                using T = std::conditional_t<std::is_integral_v<X> && std::is_integral_v<E>,
+                                             std::common_type_t<E, X>, E>;
+                return scalar<T>{static_cast<T>(x)};
+            } else {
+                return node_of<X>::make(x);
+            }
+        }
+
+        template <class F, class L, class R>
+        auto make_binary(const L& l, const R& r, F fn) {
+            auto ln = as_node<R>(l);
+            auto rn = as_node<L>(r);
+            return binary<F, decltype(ln), decltype(rn)>(std::move(ln), std::move(rn), std::move(fn));
+        }
+
+        /**
+         * @brief out[i] = e[i] for i in [first, last)
+         */
+        template <class U, class E>
+        void evaluate_range(U* out, const E& e, size_t first, size_t last) {
+            size_t i = first;
+            for (; i + block <= last; i += block) {
+                SHARED_EXPR_INDEPENDENT_LOOP
+                for (size_t j = 0; j < block; j++) out[i + j] = static_cast<U>(e[i + j]);
+            }
+            for (; i < last; i++) out[i] = static_cast<U>(e[i]);
+        }
+    }
+
+    template <class E>
+    template <class U>
+    void vector_expression<E>::evaluate_into(vector<U>& dst) const {
+        const E& e = derived();
+        if (dst.size() != e.size()) dst.resize(e.size());
+        expr::evaluate_range(dst.data(), e, 0, e.size());
+    }
+
+    /**
+     * @brief dst = e, evaluated in line-aligned chunks on pool's workers
+     * Growing dst constructs the new elements on the pool too (first-touch placement)
+     */
+    template <class U, class E, typename = std::enable_if_t<std::is_base_of_v<vector_expression<E>, E>>>
+    void evaluate(vector<U>& dst, const E& e, thread_pool& pool) {
+        const size_t n = e.size();
+        if (dst.size() != n) dst.resize(n, U(), pool);
+        if (n < expr::parallel_threshold || pool.size() < 2) {
+            expr::evaluate_range(dst.data(), e, 0, n);
+            return;
+        }
+        const size_t blocks = (n + expr::block - 1) / expr::block;
+        const size_t chunks = std::min(blocks, pool.size() * 4);
+        U* out = dst.data();
+        pool.parallel_for(chunks, [&](size_t i) {
+            const size_t first = std::min(blocks * i / chunks * expr::block, n);
+            const size_t last = std::min(blocks * (i + 1) / chunks * expr::block, n);
+            expr::evaluate_range(out, e, first, last);
+        });
+    }
+
+    template <class L, class R, typename = std::enable_if_t<expr::is_operand_pair_v<L, R>>>
+    auto operator+(const L& l, const R& r) { return expr::make_binary(l, r, std::plus<>()); }
+
+    template <class L, class R, typename = std::enable_if_t<expr::is_operand_pair_v<L, R>>>
+    auto operator-(const L& l, const R& r) { return expr::make_binary(l, r, std::minus<>()); }
+
+    template <class L, class R, typename = std::enable_if_t<expr::is_operand_pair_v<L, R>>>
+    auto operator*(const L& l, const R& r) { return expr::make_binary(l, r, std::multiplies<>()); }
+
+    template <class L, class R, typename = std::enable_if_t<expr::is_operand_pair_v<L, R>>>
+    auto operator/(const L& l, const R& r) { return expr::make_binary(l, r, std::divides<>()); }
+
+    template <class A, typename = std::enable_if_t<expr::is_node_v<A>>>
+    auto operator-(const A& a) {
+        auto node = expr::node_of<A>::make(a);
+        return expr::unary<std::negate<>, decltype(node)>(std::move(node), std::negate<>());
+    }
+
+    /**
+     * @brief Lazy fn(a[i]) for every i
+     */
+    template <class A, class F, typename = std::enable_if_t<expr::is_node_v<A>>>
+    auto transform(const A& a, F fn) {
+        auto node = expr::node_of<A>::make(a);
+        return expr::unary<F, decltype(node)>(std::move(node), std::move(fn));
+    }
+
+    /**
+     * @brief Lazy fn(l[i], r[i]) for every i; either side may be a scalar
+     */
+    template <class L, class R, class F, typename = std::enable_if_t<expr::is_operand_pair_v<L, R>>>
+    auto transform(const L& l, const R& r, F fn) { return expr::make_binary(l, r, std::move(fn)); }
+}
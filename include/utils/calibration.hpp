@@ -0,0 +1,191 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace benchy {
+    namespace utils { // Hardware calibration helpers
+
+        /**
+         * STREAM kernels (McCalpin) over double arrays.
+         * Bytes moved per element: copy/scale 16, add/triad 24 (write-allocate not counted).
+         */
+        inline void stream_copy(double* c, const double* a, size_t n) {
+            for (size_t i = 0; i < n; ++i) c[i] = a[i];
+        }
+
+        inline void stream_scale(double* b, const double* c, double scalar, size_t n) {
+            for (size_t i = 0; i < n; ++i) b[i] = scalar * c[i];
+        }
+
+        inline void stream_add(double* c, const double* a, const double* b, size_t n) {
+            for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i];
+        }
+
+        inline void stream_triad(double* a, const double* b, const double* c, double scalar, size_t n) {
+            for (size_t i = 0; i < n; ++i) a[i] = b[i] + scalar * c[i];
+        }
+
+        /**
+         * Read-only sweep, the roof for container scans
+         */
+        inline double stream_sum(const double* a, size_t n) {
+            double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                s0 += a[i];
+                s1 += a[i + 1];
+                s2 += a[i + 2];
+                s3 += a[i + 3];
+            }
+            for (; i < n; ++i) s0 += a[i];
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        /**
+         * One node per cache line so every hop is a distinct line
+         */
+        struct alignas(64) chase_node {
+            uint64_t next;
+            char pad[64 - sizeof(uint64_t)];
+        };
+
+        /**
+         * Builds a single random cycle (Sattolo's algorithm) over all nodes,
+         * defeating hardware prefetchers for a pure load-to-use latency measurement
+         */
+        inline std::vector<chase_node> make_pointer_chase(size_t nodes, uint64_t seed = 42) {
+            std::vector<uint64_t> order(nodes);
+            std::iota(order.begin(), order.end(), 0);
+            std::mt19937_64 gen(seed);
+            for (size_t i = nodes - 1; i > 0; --i) {
+                std::uniform_int_distribution<size_t> dis(0, i - 1);
+                std::swap(order[i], order[dis(gen)]);
+            }
+
+            std::vector<chase_node> chain(nodes);
+            for (size_t i = 0; i < nodes; ++i) {
+                chain[order[i]].next = order[(i + 1) % nodes];
+            }
+            return chain;
+        }
+
+        inline uint64_t chase(const chase_node* chain, uint64_t start, size_t hops) {
+            uint64_t p = start;
+            for (size_t i = 0; i < hops; ++i) {
+                p = chain[p].next;
+            }
+            return p;
+        }
+
+        /**
+         * Size of the last data cache level reported by Google Benchmark, 8 MB if unknown
+         */
+        inline size_t last_level_cache_bytes() {
+            size_t llc = 0;
+            for (const auto& cache : benchmark::CPUInfo::Get().caches) {
+                if (cache.type != "Instruction") {
+                    llc = std::max(llc, static_cast<size_t>(cache.size));
+                }
+            }
+            return llc ? llc : (size_t(8) << 20);
+        }
+
+        /**
+         * Per-array working set that is safely DRAM resident (4x LLC, clamped to 64-256 MB)
+         */
+        inline size_t dram_working_set_bytes() {
+            return std::clamp(last_level_cache_bytes() * 4, size_t(64) << 20, size_t(256) << 20);
+        }
+
+        /**
+         * Labels a working set with the smallest cache level that holds it
+         */
+        inline std::string cache_level_label(size_t bytes) {
+            std::vector<std::pair<int, size_t>> levels;
+            for (const auto& cache : benchmark::CPUInfo::Get().caches) {
+                if (cache.type != "Instruction") {
+                    levels.emplace_back(cache.level, static_cast<size_t>(cache.size));
+                }
+            }
+            std::sort(levels.begin(), levels.end());
+            for (const auto& level : levels) {
+                if (bytes <= level.second) {
+                    return "L" + std::to_string(level.first);
+                }
+            }
+            return "DRAM";
+        }
+
+        /**
+         * Measured hardware ceilings used to express container results as a fraction of the roof
+         */
+        struct memory_roofs {
+            double read_bytes_per_sec;    // sequential read sweep over a DRAM-resident array
+            double triad_bytes_per_sec;   // STREAM triad over DRAM-resident arrays
+            double random_reads_per_sec;  // independent random 8-byte reads over DRAM
+            double dram_latency_ns;       // dependent pointer-chase hop over DRAM
+        };
+
+        /**
+         * Runs each roof kernel once (best of three) on first use and caches the result
+         */
+        inline const memory_roofs& calibrated_roofs() {
+            static const memory_roofs roofs = [] {
+                using clock = std::chrono::steady_clock;
+                auto best_seconds = [](auto&& kernel) {
+                    double best = 1e30;
+                    for (int rep = 0; rep < 3; ++rep) {
+                        auto start = clock::now();
+                        kernel();
+                        best = std::min(best, std::chrono::duration<double>(clock::now() - start).count());
+                    }
+                    return best;
+                };
+
+                memory_roofs r{};
+                const size_t n = dram_working_set_bytes() / sizeof(double);
+                std::vector<double> a(n, 1.0), b(n, 2.0), c(n, 0.0);
+
+                double sum = 0;
+                r.read_bytes_per_sec = n * sizeof(double) / best_seconds([&] { sum += stream_sum(a.data(), n); });
+                r.triad_bytes_per_sec = 3 * n * sizeof(double) /
+                    best_seconds([&] { stream_triad(c.data(), a.data(), b.data(), 3.0, n); });
+                benchmark::DoNotOptimize(sum);
+                benchmark::DoNotOptimize(c.data());
+
+                std::vector<uint64_t> idx(size_t(1) << 20);
+                std::mt19937_64 gen(7);
+                for (auto& i : idx) i = gen() % n;
+                const uint64_t* words = reinterpret_cast<const uint64_t*>(a.data());
+                uint64_t acc = 0;
+                r.random_reads_per_sec = idx.size() / best_seconds([&] {
+                    for (uint64_t i : idx) acc += words[i];
+                });
+                benchmark::DoNotOptimize(acc);
+
+                const size_t nodes = dram_working_set_bytes() / sizeof(chase_node);
+                auto chain = make_pointer_chase(nodes);
+                const size_t hops = size_t(1) << 20;
+                uint64_t p = 0;
+                r.dram_latency_ns = 1e9 * best_seconds([&] { p = chase(chain.data(), p, hops); }) / hops;
+                benchmark::DoNotOptimize(p);
+                return r;
+            }();
+            return roofs;
+        }
+
+        /**
+         * Percentage of `roof_per_sec` achieved when `amount` units were processed in `seconds`
+         */
+        inline double percent_of_roof(double amount, double seconds, double roof_per_sec) {
+            return seconds > 0 ? amount / seconds * 100.0 / roof_per_sec : 0.0;
+        }
+
+    }
+}
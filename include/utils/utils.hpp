@@ -1,4 +1,7 @@
 #pragma once
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
 #include <random>
 #include <vector>
 #include <string>
@@ -41,5 +44,74 @@ namespace benchy {
             return data;
         }
 
+        /**
+         * Key distributions that stress hash functions differently under power-of-two masking
+         * - sequential:   0, 1, 2, ... (dense integer IDs)
+         * - strided:      multiples of 4096 (page-aligned offsets, only high bits vary)
+         * - pointer_like: 16-byte aligned addresses above a heap-like base
+         */
+        enum class key_pattern { sequential = 0, strided = 1, pointer_like = 2 };
+
+        inline const char* key_pattern_name(key_pattern pattern) {
+            switch (pattern) {
+                case key_pattern::sequential: return "sequential";
+                case key_pattern::strided: return "strided";
+                default: return "pointer_like";
+            }
+        }
+
+        inline std::vector<uint64_t> generate_pattern_keys(size_t size, key_pattern pattern) {
+            std::vector<uint64_t> keys;
+            keys.reserve(size);
+            for (uint64_t i = 0; i < size; ++i) {
+                switch (pattern) {
+                    case key_pattern::sequential: keys.push_back(i); break;
+                    case key_pattern::strided: keys.push_back(i * 4096); break;
+                    case key_pattern::pointer_like: keys.push_back(0x00007f3a9c000000ull + i * 16); break;
+                }
+            }
+            return keys;
+        }
+
+        /**
+         * Path for a scratch file in the system temp directory, unique per name
+         * within this process. Callers own removal.
+         */
+        inline std::string temp_file_path(const std::string& name) {
+            static const auto stamp = std::random_device{}();
+            return (std::filesystem::temp_directory_path() /
+                    ("benchy_" + std::to_string(stamp) + "_" + name)).string();
+        }
+
+        /**
+         * Scratch file path that is removed when the owner goes out of scope
+         * (function-local statics clean up at process exit)
+         */
+        struct scratch_file {
+            std::string path;
+
+            explicit scratch_file(const std::string& name) : path(temp_file_path(name)) {}
+            ~scratch_file() { std::remove(path.c_str()); }
+
+            scratch_file(const scratch_file&) = delete;
+            scratch_file& operator=(const scratch_file&) = delete;
+        };
+
+        /**
+         * Scratch directory path whose tree is removed when the owner goes out of scope
+         */
+        struct scratch_dir {
+            std::string path;
+
+            explicit scratch_dir(const std::string& name) : path(temp_file_path(name)) {}
+            ~scratch_dir() {
+                std::error_code ec;
+                std::filesystem::remove_all(path, ec);
+            }
+
+            scratch_dir(const scratch_dir&) = delete;
+            scratch_dir& operator=(const scratch_dir&) = delete;
+        };
+
     }
 }
\ No newline at end of file
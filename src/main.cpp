@@ -1,5 +1,22 @@
 #include <benchmark/benchmark.h>
 #include "../include/benchmarks/map_benchmarks.hpp"
 #include "../include/benchmarks/vector_benchmarks.hpp"
+#include "../include/benchmarks/hash_benchmarks.hpp"
+#include "../include/benchmarks/calibration_benchmarks.hpp"
+#include "../include/benchmarks/amac_benchmarks.hpp"
+#include "../include/benchmarks/file_vector_benchmarks.hpp"
+#include "../include/benchmarks/external_sort_benchmarks.hpp"
+#include "../include/benchmarks/ingest_benchmarks.hpp"
+#include "../include/benchmarks/async_loader_benchmarks.hpp"
+#include "../include/benchmarks/numa_benchmarks.hpp"
+#include "../include/benchmarks/streaming_benchmarks.hpp"
+#include "../include/benchmarks/segmented_map_benchmarks.hpp"
+#include "../include/benchmarks/disk_map_benchmarks.hpp"
+#include "../include/benchmarks/log_kv_benchmarks.hpp"
+#include "../include/benchmarks/parallel_benchmarks.hpp"
+#include "../include/benchmarks/cow_vector_benchmarks.hpp"
+#include "../include/benchmarks/persistent_vector_benchmarks.hpp"
+#include "../include/benchmarks/mdarray_benchmarks.hpp"
+#include "../include/benchmarks/vector_expr_benchmarks.hpp"
 
 BENCHMARK_MAIN(); 
\ No newline at end of file